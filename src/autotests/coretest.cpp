@@ -0,0 +1,880 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// own
+#include "batchenvironment.h"
+#include "counterrandom.h"
+#include "minefield.h"
+#include "mineprobability.h"
+#include "minesolver.h"
+#include "noguessgenerator.h"
+#include "workstealingpool.h"
+// Qt
+#include <QTest>
+// Std
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+
+struct Level
+{
+    int rows;
+    int cols;
+    int mines;
+};
+
+/**
+ * Small fields of all shapes: standard ones, single rows and columns,
+ * as dense as allowed and the transposed shapes of 10x20 and 9x16, which
+ * have the same padded size
+ */
+const Level s_levels[] = {
+    { 9, 9, 10 },
+    { 16, 30, 99 },
+    { 1, 30, 8 },
+    { 30, 1, 8 },
+    { 8, 8, 54 },
+    { 10, 20, 30 },
+    { 20, 10, 30 },
+    { 9, 16, 20 },
+    { 16, 9, 20 }
+};
+
+std::vector<int> neighboursOf(const MineField& field, int idx)
+{
+    std::vector<int> result;
+    const int row = field.rowOf(idx);
+    const int col = field.colOf(idx);
+    for (int r = row - 1; r <= row + 1; ++r)
+        for (int c = col - 1; c <= col + 1; ++c)
+        {
+            if ((r != row || c != col) && r >= 0 && r < field.rowCount() && c >= 0 && c < field.columnCount())
+                result.push_back(field.index(r, c));
+        }
+    return result;
+}
+
+int minesAround(const MineField& field, int idx)
+{
+    int mines = 0;
+    for (int n : neighboursOf(field, idx))
+        mines += field.hasMine(n);
+    return mines;
+}
+
+bool isEmpty(const MineField& field, int idx)
+{
+    return !field.hasMine(idx) && minesAround(field, idx) == 0;
+}
+
+/**
+ * Labels openings by flood fill from empty cells in index order, -1 for other cells
+ *
+ * @return number of openings
+ */
+int floodOpenings(const MineField& field, std::vector<int>& labels)
+{
+    labels.assign(field.cellCount(), -1);
+    int numOpenings = 0;
+    for (int idx = 0; idx < field.cellCount(); ++idx)
+    {
+        if (labels[idx] >= 0 || !isEmpty(field, idx))
+            continue;
+        std::vector<int> stack(1, idx);
+        labels[idx] = numOpenings;
+        while (!stack.empty())
+        {
+            const int cell = stack.back();
+            stack.pop_back();
+            for (int n : neighboursOf(field, cell)) {
+                if (labels[n] < 0 && isEmpty(field, n))
+                {
+                    labels[n] = numOpenings;
+                    stack.push_back(n);
+                }
+            }
+        }
+        ++numOpenings;
+    }
+    return numOpenings;
+}
+
+/**
+ * Checks mines, digits, openings and 3BV of a generated field
+ */
+void checkLayout(const MineField& field)
+{
+    int mines = 0;
+    for (int idx = 0; idx < field.cellCount(); ++idx)
+    {
+        mines += field.hasMine(idx);
+        QCOMPARE(field.digit(idx), field.hasMine(idx) ? 0 : minesAround(field, idx));
+        QCOMPARE(static_cast<int>(field.neighbours(idx).count), static_cast<int>(neighboursOf(field, idx).size()));
+    }
+    QCOMPARE(mines, field.minesCount());
+
+    std::vector<int> labels;
+    const int numOpenings = floodOpenings(field, labels);
+    QCOMPARE(field.openingCount(), numOpenings);
+    int bbbv = numOpenings;
+    for (int idx = 0; idx < field.cellCount(); ++idx)
+    {
+        QCOMPARE(field.openingOf(idx), labels[idx]);
+        if (field.hasMine(idx) || labels[idx] >= 0)
+            continue;
+        bool bordersOpening = false;
+        for (int n : neighboursOf(field, idx))
+            bordersOpening = bordersOpening || labels[n] >= 0;
+        bbbv += !bordersOpening;
+    }
+    QCOMPARE(field.bbbv(), bbbv);
+}
+
+/**
+ * Straightforward model of the rules, played along MineField on its mines
+ */
+class Reference
+{
+public:
+    Reference(const MineField& field, bool useQuestionMarks)
+        : m_field(field), m_state(field.cellCount(), KMinesState::Released), m_useQuestionMarks(useQuestionMarks)
+    {
+    }
+
+    KMinesState::CellState state(int idx) const { return m_state[idx]; }
+    bool isGameOver() const { return m_gameOver; }
+    int flaggedCount() const
+    {
+        int flagged = 0;
+        for (KMinesState::CellState state : m_state)
+            flagged += state == KMinesState::Flagged;
+        return flagged;
+    }
+
+    MineField::GameResult reveal(int idx)
+    {
+        if (m_gameOver || m_state[idx] != KMinesState::Released)
+            return MineField::GameContinues;
+        if (m_field.hasMine(idx))
+        {
+            m_gameOver = true;
+            for (int cell = 0; cell < m_field.cellCount(); ++cell)
+            {
+                const bool flagged = m_state[cell] == KMinesState::Flagged;
+                if (flagged && !m_field.hasMine(cell))
+                    m_state[cell] = KMinesState::Error;
+                else if (!flagged && m_field.hasMine(cell))
+                    m_state[cell] = KMinesState::Revealed;
+            }
+            return MineField::GameLost;
+        }
+
+        // marked cells stop the opening
+        std::vector<int> stack(1, idx);
+        m_state[idx] = KMinesState::Revealed;
+        while (!stack.empty())
+        {
+            const int cell = stack.back();
+            stack.pop_back();
+            if (minesAround(m_field, cell) != 0)
+                continue;
+            for (int n : neighboursOf(m_field, cell)) {
+                if (m_state[n] == KMinesState::Released)
+                {
+                    m_state[n] = KMinesState::Revealed;
+                    stack.push_back(n);
+                }
+            }
+        }
+
+        int unrevealed = 0;
+        for (KMinesState::CellState state : m_state)
+            unrevealed += state != KMinesState::Revealed;
+        if (unrevealed != m_field.minesCount())
+            return MineField::GameContinues;
+        m_gameOver = true;
+        for (KMinesState::CellState& state : m_state) {
+            if (state != KMinesState::Revealed)
+                state = KMinesState::Flagged;
+        }
+        return MineField::GameWon;
+    }
+
+    MineField::GameResult chord(int idx)
+    {
+        if (m_gameOver || m_state[idx] != KMinesState::Revealed)
+            return MineField::GameContinues;
+        int flags = 0;
+        for (int n : neighboursOf(m_field, idx))
+            flags += m_state[n] == KMinesState::Flagged;
+        if (flags == 0 || flags != minesAround(m_field, idx))
+            return MineField::GameContinues;
+        MineField::GameResult result = MineField::GameContinues;
+        for (int n : neighboursOf(m_field, idx)) {
+            if (result == MineField::GameContinues)
+                result = reveal(n);
+        }
+        return result;
+    }
+
+    void mark(int idx)
+    {
+        if (m_gameOver)
+            return;
+        switch (m_state[idx])
+        {
+            case KMinesState::Released:
+                m_state[idx] = KMinesState::Flagged;
+                break;
+            case KMinesState::Flagged:
+                m_state[idx] = m_useQuestionMarks ? KMinesState::Questioned : KMinesState::Released;
+                break;
+            case KMinesState::Questioned:
+                m_state[idx] = KMinesState::Released;
+                break;
+            default:
+                break;
+        }
+    }
+
+private:
+    const MineField& m_field;
+    std::vector<KMinesState::CellState> m_state;
+    bool m_useQuestionMarks;
+    bool m_gameOver = false;
+};
+
+enum ActionType { Reveal, Chord, Mark };
+
+struct Action
+{
+    ActionType type;
+    int idx;
+};
+
+/**
+ * Applies action to field and reference, checking that they agree
+ * and that every changed cell is listed by the field
+ */
+void apply(MineField& field, Reference& reference, const Action& action, bool useQuestionMarks)
+{
+    std::vector<KMinesState::CellState> before(field.cellCount());
+    for (int idx = 0; idx < field.cellCount(); ++idx)
+        before[idx] = field.state(idx);
+    field.clearChanges();
+
+    switch (action.type)
+    {
+        case Reveal:
+            QCOMPARE(field.reveal(action.idx), reference.reveal(action.idx));
+            break;
+        case Chord:
+            QCOMPARE(field.chord(action.idx), reference.chord(action.idx));
+            break;
+        case Mark:
+            field.mark(action.idx, useQuestionMarks);
+            reference.mark(action.idx);
+            break;
+    }
+
+    QCOMPARE(field.isGameOver(), reference.isGameOver());
+    if (!field.isGameOver())
+        QCOMPARE(field.flaggedCount(), reference.flaggedCount());
+    std::vector<bool> listed(field.cellCount(), false);
+    for (int idx : field.changedCells())
+        listed[idx] = true;
+    for (int idx = 0; idx < field.cellCount(); ++idx)
+    {
+        QCOMPARE(field.state(idx), reference.state(idx));
+        if (field.state(idx) != before[idx])
+            QVERIFY2(listed[idx], "a changed cell is missing from changedCells()");
+    }
+}
+
+/**
+ * Unknown neighbours of the digit at idx and the mines missing around it
+ */
+std::vector<int> unknownAround(const MineField& field, const MineSolver& solver, int idx, int& missing)
+{
+    std::vector<int> result;
+    missing = field.digit(idx);
+    for (int n : neighboursOf(field, idx))
+    {
+        if (solver.knowledge(n) == MineSolver::Unknown)
+            result.push_back(n);
+        else if (solver.knowledge(n) == MineSolver::Mine)
+            --missing;
+    }
+    return result;
+}
+
+/**
+ * Checks that cells the solver deduced are what they are, and that
+ * neither a digit alone nor a pair of digits tells more than it found
+ */
+void checkSolver(const MineField& field, const MineSolver& solver)
+{
+    for (int idx = 0; idx < field.cellCount(); ++idx)
+    {
+        if (solver.isMine(idx))
+            QVERIFY2(field.hasMine(idx), "the solver deduced a mine on a safe cell");
+        else if (solver.isSafe(idx))
+            QVERIFY2(!field.hasMine(idx), "the solver deduced a mined cell to be safe");
+    }
+
+    for (int a = 0; a < field.cellCount(); ++a)
+    {
+        int missingA = 0;
+        const std::vector<int> cellsA = field.isRevealed(a) ? unknownAround(field, solver, a, missingA) : std::vector<int>();
+        if (cellsA.empty())
+            continue;
+        const int unknownA = static_cast<int>(cellsA.size());
+        QVERIFY2(missingA > 0 && missingA < unknownA, "a digit is left with all its unknown cells safe or mined");
+        for (int b = 0; b < field.cellCount(); ++b)
+        {
+            if (b == a || !field.isRevealed(b) || std::abs(field.rowOf(b) - field.rowOf(a)) > 2
+                || std::abs(field.colOf(b) - field.colOf(a)) > 2)
+                continue;
+            int missingB = 0;
+            const std::vector<int> cellsB = unknownAround(field, solver, b, missingB);
+            int shared = 0;
+            for (int n : cellsB)
+                shared += static_cast<int>(std::count(cellsA.begin(), cellsA.end(), n));
+            if (shared == 0)
+                continue;
+            const int onlyA = unknownA - shared;
+            const int onlyB = static_cast<int>(cellsB.size()) - shared;
+            const int minShared = std::max({ 0, missingA - onlyA, missingB - onlyB });
+            const int maxShared = std::min({ shared, missingA, missingB });
+            QVERIFY2(onlyA == 0 || (minShared < missingA && missingA - maxShared < onlyA),
+                     "a pair of digits tells more about the cells of one of them");
+            QVERIFY2(onlyB == 0 || (minShared < missingB && missingB - maxShared < onlyB),
+                     "a pair of digits tells more about the cells of the other one");
+        }
+    }
+}
+
+/**
+ * Plays a random game of level on field, against Reference, then plays it
+ * again after MineField::reset(). Some cells may be marked before the first
+ * reveal and the field may be flipped, like BoardQueue::take() does
+ */
+void playGame(MineField& field, const Level& level, int game)
+{
+    CounterRandom random(CounterRandom(level.rows*1000 + level.cols).at(game));
+    const bool useQuestionMarks = game % 2 == 1;
+    const bool flipHorizontally = game % 3 == 1;
+    const bool flipVertically = game % 5 >= 3;
+    field.init(level.rows, level.cols, level.mines);
+    const int cells = field.cellCount();
+    const auto randomCell = [&random, cells]() { return static_cast<int>(random.bounded(cells)); };
+
+    std::vector<Action> actions;
+    Reference reference(field, useQuestionMarks);
+    for (int i = 0; i < game % 4; ++i)
+    {
+        actions.push_back({ Mark, randomCell() });
+        apply(field, reference, actions.back(), useQuestionMarks);
+        if (QTest::currentTestFailed())
+            return;
+    }
+    int first = randomCell();
+    while (field.state(first) != KMinesState::Released)
+        first = randomCell();
+
+    // the first revealed cell is empty, once flipped
+    const int generatedAt = field.index(flipVertically ? level.rows - 1 - field.rowOf(first) : field.rowOf(first),
+                                        flipHorizontally ? level.cols - 1 - field.colOf(first) : field.colOf(first));
+    field.generate(generatedAt, random.next());
+    if (flipHorizontally || flipVertically)
+        field.flip(flipHorizontally, flipVertically);
+    checkLayout(field);
+    QVERIFY(isEmpty(field, first));
+    if (QTest::currentTestFailed())
+        return;
+    std::vector<bool> mines(cells);
+    for (int idx = 0; idx < cells; ++idx)
+        mines[idx] = field.hasMine(idx);
+
+    MineSolver solver;
+    solver.reset(field);
+    actions.push_back({ Reveal, first });
+    for (int step = 0; step < 300; ++step)
+    {
+        std::vector<bool> revealed(cells);
+        for (int idx = 0; idx < cells; ++idx)
+            revealed[idx] = field.isRevealed(idx);
+        apply(field, reference, actions.back(), useQuestionMarks);
+        if (QTest::currentTestFailed() || field.isGameOver())
+            break;
+
+        for (int idx = 0; idx < cells; ++idx) {
+            if (!revealed[idx] && field.isRevealed(idx))
+                solver.cellRevealed(idx);
+        }
+        solver.update();
+        checkSolver(field, solver);
+        const int safe = solver.safeCell();
+        QVERIFY(safe < 0 || (solver.isSafe(safe) && !field.isRevealed(safe)));
+        const int unmarkedSafe = solver.unmarkedSafeCell();
+        QVERIFY(unmarkedSafe < 0 || field.state(unmarkedSafe) == KMinesState::Released);
+        if (QTest::currentTestFailed())
+            return;
+
+        // mostly moves of a careful player, so games last
+        const int kind = static_cast<int>(random.bounded(20));
+        int idx = randomCell();
+        if (kind < 10)
+        {
+            for (int tries = 0; tries < 10 && (field.hasMine(idx) || field.isRevealed(idx)); ++tries)
+                idx = randomCell();
+            actions.push_back({ Reveal, idx });
+        }
+        else if (kind < 12)
+            actions.push_back({ Reveal, idx });
+        else if (kind < 15)
+        {
+            for (int tries = 0; tries < 10 && !field.isRevealed(idx); ++tries)
+                idx = randomCell();
+            actions.push_back({ Chord, idx });
+        }
+        else
+        {
+            for (int tries = 0; tries < 10 && kind < 18 && !field.hasMine(idx); ++tries)
+                idx = randomCell();
+            actions.push_back({ Mark, idx });
+        }
+    }
+    if (QTest::currentTestFailed())
+        return;
+
+    // the same game again on the same mines
+    field.reset();
+    QVERIFY(!field.isGameOver());
+    QCOMPARE(field.flaggedCount(), 0);
+    for (int idx = 0; idx < cells; ++idx)
+    {
+        QCOMPARE(field.state(idx), KMinesState::Released);
+        QCOMPARE(field.hasMine(idx), static_cast<bool>(mines[idx]));
+    }
+    checkLayout(field);
+    Reference replay(field, useQuestionMarks);
+    for (const Action& action : actions)
+    {
+        apply(field, replay, action, useQuestionMarks);
+        if (QTest::currentTestFailed() || field.isGameOver())
+            return;
+    }
+}
+
+std::vector<int> unknownCells(const MineField& field)
+{
+    std::vector<int> cells;
+    for (int idx = 0; idx < field.cellCount(); ++idx) {
+        if (!field.isRevealed(idx))
+            cells.push_back(idx);
+    }
+    return cells;
+}
+
+/**
+ * Counts, for each unknown cell, the placements of the mines which agree
+ * with the revealed digits and hold a mine there
+ *
+ * @return number of placements agreeing with the digits
+ */
+double countPlacements(const MineField& field, const std::vector<int>& unknown, std::vector<double>& withMine)
+{
+    std::vector<bool> mined(field.cellCount(), false);
+    std::vector<int> chosen;
+    withMine.assign(unknown.size(), 0);
+    double total = 0;
+    const auto agrees = [&field, &mined]() {
+        for (int idx = 0; idx < field.cellCount(); ++idx)
+        {
+            if (!field.isRevealed(idx))
+                continue;
+            int mines = 0;
+            for (int n : neighboursOf(field, idx))
+                mines += mined[n];
+            if (mines != field.digit(idx))
+                return false;
+        }
+        return true;
+    };
+    // all combinations of minesCount() unknown cells, in lexicographic order
+    std::vector<int> combination(field.minesCount());
+    for (int i = 0; i < field.minesCount(); ++i)
+        combination[i] = i;
+    while (true)
+    {
+        for (int i : combination)
+            mined[unknown[i]] = true;
+        if (agrees())
+        {
+            total += 1;
+            for (int i : combination)
+                withMine[i] += 1;
+        }
+        for (int i : combination)
+            mined[unknown[i]] = false;
+
+        int i = field.minesCount() - 1;
+        while (i >= 0 && combination[i] == static_cast<int>(unknown.size()) - field.minesCount() + i)
+            --i;
+        if (i < 0)
+            break;
+        ++combination[i];
+        for (int j = i + 1; j < field.minesCount(); ++j)
+            combination[j] = combination[j - 1] + 1;
+    }
+    return total;
+}
+
+}
+
+/**
+ * Checks the engine against brute force on small fields: generated digits,
+ * openings and 3BV, reproducible and no-guess fields, game rules, flipped
+ * and reshaped fields, solver deductions, mine probabilities and batched
+ * boards
+ */
+class CoreTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    /**
+     * Fields only depend on seed, size, mines and first click,
+     * which is empty
+     */
+    void generate()
+    {
+        MineField field;
+        MineField again;
+        for (const Level& level : s_levels)
+            for (int seed = 0; seed < 20; ++seed)
+            {
+                const int clicked = (seed * 37) % (level.rows * level.cols);
+                field.init(level.rows, level.cols, level.mines);
+                field.generate(clicked, seed);
+                checkLayout(field);
+                QVERIFY(isEmpty(field, clicked));
+
+                again.init(level.rows, level.cols, level.mines);
+                again.generate(clicked, seed);
+                for (int idx = 0; idx < field.cellCount(); ++idx)
+                    QCOMPARE(again.hasMine(idx), field.hasMine(idx));
+            }
+    }
+
+    /**
+     * Random numbers and fields are the same on every platform:
+     * CounterRandom gives the numbers of SplitMix64
+     */
+    void reproducible()
+    {
+        CounterRandom random(0);
+        QCOMPARE(random.next(), std::uint64_t(0xe220a8397b1dcdafULL));
+        QCOMPARE(random.next(), std::uint64_t(0x6e789e6aa1b965f4ULL));
+        QCOMPARE(random.next(), std::uint64_t(0x06c45d188009454fULL));
+        QCOMPARE(CounterRandom(0).at(2), std::uint64_t(0x06c45d188009454fULL));
+
+        MineField field;
+        field.init(9, 9, 10);
+        field.generate(40, 2026);
+        const std::vector<int> expected = { 3, 23, 29, 37, 57, 62, 66, 68, 70, 77 };
+        std::vector<int> mines;
+        for (int idx = 0; idx < field.cellCount(); ++idx) {
+            if (field.hasMine(idx))
+                mines.push_back(idx);
+        }
+        QVERIFY(mines == expected);
+        QCOMPARE(field.origin().seed, std::uint64_t(2026));
+        QCOMPARE(field.origin().clickedIdx, 40);
+    }
+
+    /**
+     * Fields solvable without guessing are, from their first click,
+     * and are generated again from the seed of their origin
+     */
+    void noGuess()
+    {
+        MineField field;
+        MineField again;
+        MineSolver solver;
+        for (int seed = 0; seed < 10; ++seed)
+        {
+            const Level& level = s_levels[seed % 2];
+            const int clicked = (seed * 37) % (level.rows * level.cols);
+            field.init(level.rows, level.cols, level.mines);
+            QVERIFY(NoGuessGenerator::generate(field, clicked, seed, 0));
+            checkLayout(field);
+            QVERIFY(isEmpty(field, clicked));
+            QVERIFY(solver.solve(field, clicked));
+            QCOMPARE(field.origin().clickedIdx, clicked);
+
+            // the first candidate is the field of the seed itself
+            again.init(level.rows, level.cols, level.mines);
+            QVERIFY(NoGuessGenerator::generate(again, clicked, field.origin().seed, 0));
+            QCOMPARE(again.origin().seed, field.origin().seed);
+            for (int idx = 0; idx < field.cellCount(); ++idx)
+                QCOMPARE(again.hasMine(idx), field.hasMine(idx));
+        }
+    }
+
+    /**
+     * Mirrored fields are the mirrors of the generated ones
+     */
+    void flip()
+    {
+        MineField original;
+        MineField flipped;
+        for (const Level& level : s_levels)
+            for (int flips = 1; flips < 4; ++flips)
+            {
+                const bool horizontally = flips & 1;
+                const bool vertically = flips & 2;
+                original.init(level.rows, level.cols, level.mines);
+                original.generate(0, flips);
+                flipped.init(level.rows, level.cols, level.mines);
+                flipped.generate(0, flips);
+                flipped.flip(horizontally, vertically);
+                checkLayout(flipped);
+                QCOMPARE(flipped.origin().flippedHorizontally, horizontally);
+                QCOMPARE(flipped.origin().flippedVertically, vertically);
+                QCOMPARE(flipped.bbbv(), original.bbbv());
+                for (int idx = 0; idx < flipped.cellCount(); ++idx)
+                {
+                    const int row = vertically ? level.rows - 1 - flipped.rowOf(idx) : flipped.rowOf(idx);
+                    const int col = horizontally ? level.cols - 1 - flipped.colOf(idx) : flipped.colOf(idx);
+                    QCOMPARE(flipped.hasMine(idx), original.hasMine(original.index(row, col)));
+                }
+            }
+    }
+
+    /**
+     * Fields of another shape but the same padded size don't keep
+     * anything of the previous layout
+     */
+    void reshape()
+    {
+        MineField field;
+        for (int game = 0; game < 20; ++game)
+        {
+            playGame(field, s_levels[5 + game % 4], game);
+            if (QTest::currentTestFailed())
+                return;
+        }
+    }
+
+    /**
+     * Random games of every level against Reference, with marks before the
+     * first reveal and flipped fields. The field is reused from game to game
+     */
+    void play()
+    {
+        MineField field;
+        for (int game = 0; game < 30; ++game)
+            for (const Level& level : s_levels)
+            {
+                playGame(field, level, game);
+                if (QTest::currentTestFailed())
+                    return;
+            }
+    }
+
+    /**
+     * Probabilities of all unknown cells, compared with counts
+     * of all placements of the mines
+     */
+    void probabilities()
+    {
+        MineField field;
+        int positions = 0;
+        for (int seed = 0; seed < 200 && positions < 40; ++seed)
+        {
+            CounterRandom random(seed);
+            field.init(5, 6, 7);
+            const int clicked = static_cast<int>(random.bounded(field.cellCount()));
+            field.generate(clicked, seed);
+            field.reveal(clicked);
+            // some more safe cells, for various frontiers
+            for (int i = 0; i < seed % 3; ++i)
+            {
+                const int idx = static_cast<int>(random.bounded(field.cellCount()));
+                if (!field.hasMine(idx))
+                    field.reveal(idx);
+            }
+            const std::vector<int> unknown = unknownCells(field);
+            if (field.isGameOver() || unknown.size() > 22 || static_cast<int>(unknown.size()) <= field.minesCount())
+                continue;
+            ++positions;
+
+            std::vector<double> withMine;
+            const double total = countPlacements(field, unknown, withMine);
+            QVERIFY(total > 0);
+            MineSolver solver;
+            solver.reset(field);
+            for (int idx = 0; idx < field.cellCount(); ++idx) {
+                if (field.isRevealed(idx))
+                    solver.cellRevealed(idx);
+            }
+            solver.update();
+            checkSolver(field, solver);
+            MineProbability probabilities;
+            probabilities.setup(solver);
+            const std::atomic<bool> cancelled(false);
+            QVERIFY(probabilities.compute(cancelled));
+            QVERIFY(!probabilities.isApproximate());
+
+            double lowest = 2;
+            for (size_t i = 0; i < unknown.size(); ++i)
+            {
+                const double expected = withMine[i] / total;
+                QVERIFY2(std::abs(probabilities.probability(unknown[i]) - expected) < 1e-9,
+                         "probability differs from the count of placements");
+                if (solver.knowledge(unknown[i]) == MineSolver::Unknown)
+                    lowest = std::min(lowest, expected);
+            }
+            const int safest = probabilities.safestCell([](int) { return true; });
+            if (lowest <= 1)
+                QVERIFY(std::abs(probabilities.probability(safest) - lowest) < 1e-9);
+        }
+        QVERIFY(positions >= 20);
+    }
+
+    /**
+     * Frontiers too large to enumerate within the step budget
+     * are estimated, keeping the expected number of mines
+     */
+    void probabilitiesBudget()
+    {
+        MineField field;
+        field.init(60, 60, 1080);
+        field.generate(0, 5);
+        // every third column, leaving long components of two columns
+        for (int col = 0; col < field.columnCount(); col += 3)
+            for (int row = 0; row < field.rowCount(); ++row)
+            {
+                const int idx = field.index(row, col);
+                if (!field.hasMine(idx) && !field.isRevealed(idx))
+                    field.reveal(idx);
+            }
+        MineSolver solver;
+        solver.reset(field);
+        for (int idx = 0; idx < field.cellCount(); ++idx) {
+            if (field.isRevealed(idx))
+                solver.cellRevealed(idx);
+        }
+        solver.update();
+        MineProbability probabilities;
+        probabilities.setup(solver);
+        const std::atomic<bool> cancelled(false);
+        QVERIFY(probabilities.compute(cancelled, 100000));
+        QVERIFY(probabilities.isApproximate());
+
+        double mines = 0;
+        for (int idx = 0; idx < field.cellCount(); ++idx)
+        {
+            if (field.isRevealed(idx))
+                continue;
+            const double probability = probabilities.probability(idx);
+            QVERIFY(probability >= 0 && probability <= 1);
+            mines += probability;
+        }
+        QVERIFY(std::abs(mines - field.minesCount()) < 1e-6 * field.minesCount());
+    }
+
+    /**
+     * Boards of BatchEnvironment play like MineField, generated
+     * from the documented seeds, with and without a pool
+     */
+    void batchEnvironment()
+    {
+        const int numBoards = 6;
+        const std::uint64_t seed = 3;
+        BatchEnvironment environment(numBoards, 5, 6, 6, seed);
+        const int cells = environment.cellCount();
+        std::vector<MineField> fields(numBoards);
+        std::vector<std::uint64_t> games(numBoards, 0);
+        for (MineField& field : fields)
+            field.init(5, 6, 6);
+        WorkStealingPool pool(2);
+        CounterRandom random(11);
+        std::vector<int> actions(numBoards);
+
+        for (int step = 0; step < 400; ++step)
+        {
+            for (int board = 0; board < numBoards; ++board)
+            {
+                const int kind = static_cast<int>(random.bounded(20));
+                if (kind == 19)
+                {
+                    // out of range, on either side
+                    const int offset = static_cast<int>(random.bounded(cells));
+                    actions[board] = random.bounded(2) == 0 ? -1 - offset : environment.actionCount() + offset;
+                    continue;
+                }
+                const int type = kind < 12 ? BatchEnvironment::Reveal : kind < 16 ? BatchEnvironment::ToggleFlag
+                                                                                   : BatchEnvironment::Chord;
+                actions[board] = type*cells + static_cast<int>(random.bounded(cells));
+            }
+            environment.step(actions.data(), step % 2 == 0 ? nullptr : &pool);
+
+            for (int board = 0; board < numBoards; ++board)
+            {
+                if (actions[board] < 0 || actions[board] >= environment.actionCount())
+                {
+                    // the board is left as it is
+                    QCOMPARE(static_cast<int>(environment.outcomes()[board]), static_cast<int>(BatchEnvironment::INVALID_ACTION));
+                    QCOMPARE(environment.revealedCounts()[board], 0);
+                    continue;
+                }
+                MineField& field = fields[board];
+                const int idx = actions[board] % cells;
+                MineField::GameResult result = MineField::GameContinues;
+                switch (actions[board] / cells)
+                {
+                    case BatchEnvironment::Reveal:
+                        if (!field.isGenerated() && field.state(idx) == KMinesState::Released)
+                            field.generate(idx, CounterRandom(CounterRandom(seed).at(board)).at(games[board]));
+                        result = field.reveal(idx);
+                        break;
+                    case BatchEnvironment::ToggleFlag:
+                        field.mark(idx, false);
+                        break;
+                    default:
+                        result = field.chord(idx);
+                        break;
+                }
+                QCOMPARE(static_cast<int>(environment.outcomes()[board]), static_cast<int>(result));
+                if (result != MineField::GameContinues)
+                {
+                    ++games[board];
+                    field.init(5, 6, 6);
+                }
+
+                for (int cell = 0; cell < cells; ++cell)
+                {
+                    const int plane = board*cells + cell;
+                    const bool revealed = field.isRevealed(cell);
+                    QCOMPARE(static_cast<bool>(environment.revealed()[plane]), revealed);
+                    QCOMPARE(static_cast<int>(environment.digits()[plane]), revealed ? field.digit(cell) : 0);
+                    QCOMPARE(static_cast<bool>(environment.flags()[plane]), field.isFlagged(cell));
+                }
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(CoreTest)
+
+#include "coretest.moc"
@@ -0,0 +1,328 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// own
+#include "externalaiserver.h"
+#include "minefielditem.h"
+#include "scene.h"
+// KDEGames
+#include <KgThemeProvider>
+// Qt
+#include <QApplication>
+#include <QLocalSocket>
+#include <QSignalSpy>
+#include <QTest>
+#include <QtEndian>
+// Std
+#include <memory>
+
+namespace
+{
+
+/**
+ * @return a frame of type with payload, as a client sends it
+ */
+QByteArray frame(quint8 type, const QByteArray& payload = QByteArray())
+{
+    QByteArray out(4, 0);
+    qToLittleEndian<quint32>(payload.size() + 1, out.data());
+    out.append(static_cast<char>(type));
+    out.append(payload);
+    return out;
+}
+
+/**
+ * @return a SubmitMoves frame of (action, cell index) moves
+ */
+QByteArray movesFrame(const QVector<QPair<quint8, quint32> >& moves)
+{
+    QByteArray payload(4 + 5*moves.size(), 0);
+    uchar* data = reinterpret_cast<uchar*>(payload.data());
+    qToLittleEndian<quint32>(moves.size(), data);
+    for(int i = 0; i < moves.size(); ++i)
+    {
+        data[4 + 5*i] = moves.at(i).first;
+        qToLittleEndian<quint32>(moves.at(i).second, data + 4 + 5*i + 1);
+    }
+    return frame(ExternalAiServer::SubmitMoves, payload);
+}
+
+/**
+ * Client side of the protocol, splitting what it receives into frames
+ */
+class Client
+{
+public:
+    explicit Client(const QString& name)
+    {
+        m_socket.connectToServer(name);
+    }
+
+    void send(const QByteArray& bytes)
+    {
+        m_socket.write(bytes);
+        m_socket.flush();
+    }
+
+    /**
+     * @return the next frame received, without its length,
+     * or an empty one if none comes
+     */
+    QByteArray nextFrame()
+    {
+        QTest::qWaitFor([this]() {
+            readFrames();
+            return !m_frames.isEmpty() || m_socket.state() == QLocalSocket::UnconnectedState;
+        }, 5000);
+        return m_frames.isEmpty() ? QByteArray() : m_frames.takeFirst();
+    }
+
+    bool waitForDisconnected()
+    {
+        return QTest::qWaitFor([this]() { return m_socket.state() == QLocalSocket::UnconnectedState; }, 5000);
+    }
+
+private:
+    void readFrames()
+    {
+        m_buffer.append(m_socket.readAll());
+        while(m_buffer.size() >= 4)
+        {
+            const quint32 length = qFromLittleEndian<quint32>(m_buffer.constData());
+            if(static_cast<quint32>(m_buffer.size() - 4) < length)
+                break;
+            m_frames.append(m_buffer.mid(4, length));
+            m_buffer.remove(0, 4 + length);
+        }
+    }
+
+    QLocalSocket m_socket;
+    QByteArray m_buffer;
+    QList<QByteArray> m_frames;
+};
+
+quint32 u32At(const QByteArray& frame, int pos)
+{
+    return qFromLittleEndian<quint32>(frame.constData() + pos);
+}
+
+}
+
+/**
+ * The local socket protocol of ExternalAiServer, as a client sees it,
+ * on an easy field generated from a fixed seed
+ */
+class ExternalAiServerTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase()
+    {
+        KMinesScene scene(nullptr);
+        if(scene.renderer().themeProvider()->themes().isEmpty())
+            QSKIP("KMines themes are not installed");
+    }
+
+    void init()
+    {
+        m_scene.reset(new KMinesScene(nullptr));
+        m_scene->setSeed(1);
+        for(QGraphicsItem* item : m_scene->items())
+            if(MineFieldItem* field = qobject_cast<MineFieldItem*>(item->toGraphicsObject()))
+                m_field = field;
+        QVERIFY(m_field);
+        m_scene->startNewGame(9, 9, 10);
+        m_server.reset(new ExternalAiServer(m_field, nullptr));
+        QVERIFY2(m_server->listen(socketName()), qPrintable(m_server->errorString()));
+    }
+
+    void cleanup()
+    {
+        m_server.reset();
+        m_scene.reset();
+        m_field = nullptr;
+    }
+
+    /**
+     * Clients are sent the whole field when they connect
+     */
+    void snapshotOnConnect()
+    {
+        Client client(socketName());
+        checkSnapshot(client.nextFrame());
+    }
+
+    void requestSnapshot()
+    {
+        Client client(socketName());
+        client.nextFrame();
+        client.send(frame(ExternalAiServer::RequestSnapshot));
+        checkSnapshot(client.nextFrame());
+    }
+
+    /**
+     * Moves are answered by the cells they changed, then by the number
+     * of moves played
+     */
+    void submitMoves()
+    {
+        Client client(socketName());
+        client.nextFrame();
+        const int center = 4*9 + 4;
+        client.send(movesFrame({ { MineFieldItem::Move::Reveal, center } }));
+
+        const QByteArray delta = client.nextFrame();
+        QVERIFY(delta.size() >= 6);
+        QCOMPARE(static_cast<quint8>(delta.at(0)), quint8(ExternalAiServer::Delta));
+        QCOMPARE(static_cast<quint8>(delta.at(1)), quint8(ExternalAiServer::Playing));
+        const quint32 count = u32At(delta, 2);
+        QVERIFY(count > 0);
+        QCOMPARE(static_cast<quint32>(delta.size()), 6 + count*5);
+        const MineField& field = m_field->field();
+        for(quint32 i = 0; i < count; ++i)
+        {
+            const int idx = static_cast<int>(u32At(delta, 6 + i*5));
+            QVERIFY(idx >= 0 && idx < field.cellCount());
+            QVERIFY(field.isRevealed(idx));
+            QCOMPARE(static_cast<int>(delta.at(6 + i*5 + 4)), field.digit(idx));
+        }
+
+        const QByteArray applied = client.nextFrame();
+        QCOMPARE(applied.size(), 6);
+        QCOMPARE(static_cast<quint8>(applied.at(0)), quint8(ExternalAiServer::MovesApplied));
+        QCOMPARE(u32At(applied, 1), quint32(1));
+    }
+
+    /**
+     * Moves on cells out of the field are skipped, not played
+     */
+    void outOfField()
+    {
+        Client client(socketName());
+        client.nextFrame();
+        client.send(movesFrame({ { MineFieldItem::Move::Reveal, 81 },
+                                 { MineFieldItem::Move::ToggleFlag, 0xffffffff } }));
+
+        // nothing changed, so no Delta
+        const QByteArray applied = client.nextFrame();
+        QCOMPARE(applied.size(), 6);
+        QCOMPARE(static_cast<quint8>(applied.at(0)), quint8(ExternalAiServer::MovesApplied));
+        QCOMPARE(u32At(applied, 1), quint32(0));
+        QVERIFY(!m_field->field().isGenerated());
+    }
+
+    /**
+     * Frames beyond a batch are handled in the next event loop iterations
+     */
+    void manyFrames()
+    {
+        Client client(socketName());
+        client.nextFrame();
+        const int count = 200;
+        QByteArray frames;
+        for(int i = 0; i < count; ++i)
+            frames.append(frame(ExternalAiServer::RequestSnapshot));
+        client.send(frames);
+        for(int i = 0; i < count; ++i)
+        {
+            checkSnapshot(client.nextFrame());
+            if(QTest::currentTestFailed())
+                return;
+        }
+    }
+
+    /**
+     * A frame received in parts is handled once complete
+     */
+    void splitFrame()
+    {
+        Client client(socketName());
+        client.nextFrame();
+        const QByteArray request = frame(ExternalAiServer::RequestSnapshot);
+        client.send(request.left(2));
+        QTest::qWait(50);
+        client.send(request.mid(2));
+        checkSnapshot(client.nextFrame());
+    }
+
+    void malformed_data()
+    {
+        QTest::addColumn<QByteArray>("bytes");
+
+        QByteArray empty(4, 0);
+        QTest::newRow("empty frame") << empty;
+        QByteArray tooLong(4, 0);
+        qToLittleEndian<quint32>(ExternalAiServer::MAX_FRAME_SIZE + 1, tooLong.data());
+        QTest::newRow("frame too long") << tooLong;
+        QTest::newRow("unknown type") << frame(0x7f);
+        QTest::newRow("snapshot request with payload") << frame(ExternalAiServer::RequestSnapshot, QByteArray(1, 0));
+        QByteArray wrongCount = movesFrame({ { MineFieldItem::Move::Reveal, 0 } });
+        qToLittleEndian<quint32>(2, wrongCount.data() + 5);
+        QTest::newRow("move count mismatch") << wrongCount;
+        QTest::newRow("unknown action") << movesFrame({ { MineFieldItem::Move::Chord + 1, 0 } });
+    }
+
+    /**
+     * Clients sending malformed frames are disconnected
+     */
+    void malformed()
+    {
+        QFETCH(QByteArray, bytes);
+        Client client(socketName());
+        client.nextFrame();
+        client.send(bytes);
+        QVERIFY(client.waitForDisconnected());
+        QVERIFY(!m_field->field().isGenerated());
+    }
+
+    void newGame()
+    {
+        QSignalSpy requested(m_server.get(), &ExternalAiServer::newGameRequested);
+        Client client(socketName());
+        client.nextFrame();
+        client.send(frame(ExternalAiServer::NewGame));
+        QTRY_COMPARE(requested.count(), 1);
+    }
+
+private:
+    static QString socketName()
+    {
+        return QStringLiteral("kmines-test-%1").arg(QCoreApplication::applicationPid());
+    }
+
+    /**
+     * Checks frame is a Snapshot of the field, not played yet
+     */
+    void checkSnapshot(const QByteArray& snapshot)
+    {
+        QCOMPARE(snapshot.size(), 1 + 2 + 2 + 4 + 1 + 81);
+        QCOMPARE(static_cast<quint8>(snapshot.at(0)), quint8(ExternalAiServer::Snapshot));
+        QCOMPARE(qFromLittleEndian<quint16>(snapshot.constData() + 1), quint16(9));
+        QCOMPARE(qFromLittleEndian<quint16>(snapshot.constData() + 3), quint16(9));
+        QCOMPARE(u32At(snapshot, 5), quint32(10));
+        QCOMPARE(static_cast<quint8>(snapshot.at(9)), quint8(ExternalAiServer::Playing));
+        for(int i = 10; i < snapshot.size(); ++i)
+            QCOMPARE(static_cast<quint8>(snapshot.at(i)), quint8(ExternalAiServer::Unrevealed));
+    }
+
+    std::unique_ptr<KMinesScene> m_scene;
+    MineFieldItem* m_field = nullptr;
+    std::unique_ptr<ExternalAiServer> m_server;
+};
+
+int main(int argc, char* argv[])
+{
+    // no display needed, the scene is never shown
+    if(!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    // themes and settings of the game
+    QApplication::setApplicationName(QStringLiteral("kmines"));
+    ExternalAiServerTest test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "externalaiservertest.moc"
@@ -0,0 +1,589 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// own
+#include "batchenvironment.h"
+#include "counterrandom.h"
+#include "minefield.h"
+#include "noguessgenerator.h"
+// Qt
+#include <QElapsedTimer>
+#include <QList>
+#include <QPair>
+#include <QTest>
+// Std
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+struct Level
+{
+    const char* name;
+    int rows;
+    int cols;
+    int mines;
+};
+
+/**
+ * Standard levels and large custom fields, as played
+ */
+const Level s_levels[] = {
+    { "Easy", 9, 9, 10 },
+    { "Medium", 16, 16, 40 },
+    { "Hard", 16, 30, 99 },
+    { "Custom 200x200", 200, 200, 8000 },
+    { "Custom 1000x1000", 1000, 1000, 50000 }
+};
+
+/**
+ * Adds rows, cols and mines columns and a row per level, named
+ * after the level followed by suffix
+ */
+void addLevelRows(const char* suffix = "")
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<int>("mines");
+    for (const Level& level : s_levels) {
+        QTest::newRow(qPrintable(QLatin1String(level.name) + QLatin1String(suffix)))
+            << level.rows << level.cols << level.mines;
+    }
+}
+
+/**
+ * @return a field generated from a fixed seed, clicked in its middle
+ */
+MineField generatedField(int rows, int cols, int mines)
+{
+    MineField field;
+    field.init(rows, cols, mines);
+    field.generate(field.index(rows/2, cols/2), 1);
+    return field;
+}
+
+/**
+ * Times only measured() over a number of runs, each on a fresh copy of
+ * prepared, and reports the average as the benchmark result. Fields are
+ * changed by moves, so QBENCHMARK would time preparing them again as well
+ */
+template<typename Measured>
+void benchmarkOn(const MineField& prepared, Measured measured)
+{
+    // fewer runs on large fields, copying them takes a while
+    const int runs = qBound(5, 1000000 / prepared.cellCount(), 1000);
+    qint64 total = 0;
+    MineField field;
+    QElapsedTimer timer;
+    for (int i = 0; i < runs; ++i) {
+        field = prepared;
+        timer.start();
+        measured(field);
+        total += timer.nsecsElapsed();
+    }
+    QTest::setBenchmarkResult(qreal(total) / runs, QTest::WalltimeNanoseconds);
+}
+
+/**
+ * @return a field one move from being won, by revealing safe cells in
+ * index order, and that move in lastMove
+ */
+MineField nearlyWonField(int rows, int cols, int mines, int* lastMove)
+{
+    const MineField generated = generatedField(rows, cols, mines);
+    MineField field = generated;
+    std::vector<int> moves;
+    for (int idx = 0; idx < field.cellCount() && !field.isGameOver(); ++idx) {
+        if (!field.hasMine(idx) && !field.isRevealed(idx)) {
+            field.reveal(idx);
+            moves.push_back(idx);
+        }
+    }
+    field = generated;
+    for (size_t i = 0; i + 1 < moves.size(); ++i)
+        field.reveal(moves[i]);
+    field.clearChanges();
+    *lastMove = moves.back();
+    return field;
+}
+
+/**
+ * @return steps batches of actions revealing safe cells only, following the
+ * fields BatchEnvironment(numBoards, rows, cols, mines, seed) generates,
+ * so games last until they are won
+ */
+std::vector<std::vector<int> > safeRevealBatches(int numBoards, int rows, int cols, int mines, std::uint64_t seed, int steps)
+{
+    std::vector<MineField> fields(numBoards);
+    std::vector<std::uint64_t> games(numBoards, 0);
+    for (MineField& field : fields)
+        field.init(rows, cols, mines);
+    const int cells = rows*cols;
+    CounterRandom random(1);
+    std::vector<std::vector<int> > batches(steps, std::vector<int>(numBoards));
+    for (std::vector<int>& actions : batches) {
+        for (int board = 0; board < numBoards; ++board) {
+            MineField& field = fields[board];
+            int idx = static_cast<int>(random.bounded(cells));
+            if (!field.isGenerated())
+                field.generate(idx, CounterRandom(CounterRandom(seed).at(board)).at(games[board]));
+            // the next safe cell still hidden, there is one until the game is won
+            while (field.hasMine(idx) || field.isRevealed(idx))
+                idx = (idx + 1) % cells;
+            actions[board] = BatchEnvironment::Reveal*cells + idx;
+            if (field.reveal(idx) == MineField::GameWon) {
+                ++games[board];
+                field.init(rows, cols, mines);
+            }
+        }
+    }
+    return batches;
+}
+
+/**
+ * Neighbour lookup as it was done by MineFieldItem before the padded board
+ * layout, kept here as a baseline for comparison
+ */
+QList<QPair<int,int> > legacyAdjacentRowColsFor(int row, int col, int numRows, int numCols)
+{
+    QList<QPair<int,int> > resultingList;
+    if(row != 0 && col != 0) // upper-left diagonal
+        resultingList.append( qMakePair(row-1,col-1) );
+    if(row != 0) // upper
+        resultingList.append(qMakePair(row-1, col));
+    if(row != 0 && col != numCols-1) // upper-right diagonal
+        resultingList.append(qMakePair(row-1, col+1));
+    if(col != 0) // on the left
+        resultingList.append(qMakePair(row,col-1));
+    if(col != numCols-1) // on the right
+        resultingList.append(qMakePair(row, col+1));
+    if(row != numRows-1 && col != 0) // bottom-left diagonal
+        resultingList.append(qMakePair(row+1, col-1));
+    if(row != numRows-1) // bottom
+        resultingList.append(qMakePair(row+1, col));
+    if(row != numRows-1 && col != numCols-1) // bottom-right diagonal
+        resultingList.append(qMakePair(row+1, col+1));
+    return resultingList;
+}
+
+}
+
+/**
+ * Benchmarks of the headless game engine hot paths
+ */
+class EngineBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void neighbours_data();
+    void neighbours();
+    void generate_data();
+    void generate();
+    void openings_data();
+    void openings();
+    void initField_data();
+    void initField();
+    void reveal_data();
+    void reveal();
+    void chord_data();
+    void chord();
+    void gameOver_data();
+    void gameOver();
+    void reset_data();
+    void reset();
+    void batchStep_data();
+    void batchStep();
+    void noGuessGenerate_data();
+    void noGuessGenerate();
+};
+
+void EngineBenchmark::neighbours_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<bool>("legacy");
+
+    QTest::newRow("50x50 legacy") << 50 << 50 << true;
+    QTest::newRow("50x50 padded") << 50 << 50 << false;
+    QTest::newRow("500x500 legacy") << 500 << 500 << true;
+    QTest::newRow("500x500 padded") << 500 << 500 << false;
+    QTest::newRow("2000x2000 legacy") << 2000 << 2000 << true;
+    QTest::newRow("2000x2000 padded") << 2000 << 2000 << false;
+}
+
+void EngineBenchmark::neighbours()
+{
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(bool, legacy);
+
+    MineField field;
+    field.init(rows, cols, 1);
+
+    // walks neighbours of every cell, the sum keeps the loop from being optimized away
+    qint64 sum = 0;
+    if (legacy) {
+        QBENCHMARK {
+            for (int row = 0; row < rows; ++row)
+                for (int col = 0; col < cols; ++col) {
+                    const QList<QPair<int,int> > list = legacyAdjacentRowColsFor(row, col, rows, cols);
+                    for (const QPair<int,int>& pos : list)
+                        sum += pos.first*cols + pos.second;
+                }
+        }
+    } else {
+        QBENCHMARK {
+            for (int idx = 0; idx < field.cellCount(); ++idx)
+                for (int n : field.neighbours(idx))
+                    sum += n;
+        }
+    }
+    QVERIFY(sum > 0);
+}
+
+void EngineBenchmark::generate_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<int>("mines");
+
+    struct Layout { const char* name; int rows; int cols; };
+    const Layout layouts[] = { { "Easy", 9, 9 }, { "Medium", 16, 16 }, { "Hard", 16, 30 }, { "Custom 50x50", 50, 50 } };
+    const int densities[] = { 10, 20, 30, 50, 70, 90, 95, 99 };
+    for (const Layout& layout : layouts) {
+        for (int density : densities) {
+            // MineField clamps the count to leave MINIMAL_FREE cells
+            const int mines = layout.rows*layout.cols*density/100;
+            QTest::newRow(qPrintable(QStringLiteral("%1 %2%").arg(QLatin1String(layout.name)).arg(density)))
+                << layout.rows << layout.cols << mines;
+        }
+    }
+    // large openings to label
+    for (int density : { 1, 5, 10 }) {
+        QTest::newRow(qPrintable(QStringLiteral("Custom 1000x1000 %1%").arg(density)))
+            << 1000 << 1000 << 1000*1000*density/100;
+    }
+    // most cells drawn on a field far larger than the caches
+    for (int density : { 50, 90, 99 }) {
+        QTest::newRow(qPrintable(QStringLiteral("Custom 2000x2000 %1%").arg(density)))
+            << 2000 << 2000 << 2000*2000*density/100;
+    }
+}
+
+void EngineBenchmark::generate()
+{
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, mines);
+
+    MineField field;
+    quint64 seed = 0;
+    QBENCHMARK {
+        field.init(rows, cols, mines);
+        field.generate(field.index(rows/2, cols/2), ++seed);
+    }
+    QVERIFY(field.isGenerated());
+}
+
+void EngineBenchmark::openings_data()
+{
+    QTest::addColumn<int>("density");
+    QTest::addColumn<bool>("marked");
+
+    for (int density : { 1, 5, 10 }) {
+        QTest::newRow(qPrintable(QStringLiteral("1000x1000 %1% labels").arg(density))) << density << false;
+        QTest::newRow(qPrintable(QStringLiteral("1000x1000 %1% span fill").arg(density))) << density << true;
+    }
+}
+
+void EngineBenchmark::openings()
+{
+    QFETCH(int, density);
+    QFETCH(bool, marked);
+
+    const int size = 1000;
+    MineField field;
+    field.init(size, size, size*size*density/100);
+    const int clicked = field.index(size/2, size/2);
+    field.generate(clicked, 1);
+
+    // a flag inside the opening makes it revealed by the span fill
+    int flagged = -1;
+    if (marked) {
+        for (int idx = 0; idx < field.cellCount() && flagged < 0; ++idx) {
+            if (idx != clicked && field.openingOf(idx) == field.openingOf(clicked))
+                flagged = idx;
+        }
+        QVERIFY(flagged >= 0);
+    }
+
+    // the reset costs as much as the reveal, in both cases
+    QBENCHMARK {
+        field.reset();
+        if (flagged >= 0)
+            field.mark(flagged, false);
+        field.clearChanges();
+        field.reveal(clicked);
+    }
+    QVERIFY(field.isRevealed(clicked));
+    QVERIFY(field.bbbv() >= field.openingCount());
+}
+
+void EngineBenchmark::initField_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<int>("mines");
+    QTest::addColumn<bool>("sameSize");
+    for (const Level& level : s_levels) {
+        QTest::newRow(qPrintable(QLatin1String(level.name) + QLatin1String(" new size")))
+            << level.rows << level.cols << level.mines << false;
+        QTest::newRow(qPrintable(QLatin1String(level.name) + QLatin1String(" same size, after a game")))
+            << level.rows << level.cols << level.mines << true;
+    }
+}
+
+void EngineBenchmark::initField()
+{
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, mines);
+    QFETCH(bool, sameSize);
+
+    int lastMove;
+    const MineField played = nearlyWonField(rows, cols, mines, &lastMove);
+    benchmarkOn(played, [=](MineField& field) {
+        field.init(rows, sameSize ? cols : cols + 1, mines);
+    });
+}
+
+void EngineBenchmark::reveal_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<int>("mines");
+    QTest::addColumn<bool>("largest");
+    for (const Level& level : s_levels) {
+        QTest::newRow(qPrintable(QLatin1String(level.name) + QLatin1String(" smallest opening")))
+            << level.rows << level.cols << level.mines << false;
+        QTest::newRow(qPrintable(QLatin1String(level.name) + QLatin1String(" largest opening")))
+            << level.rows << level.cols << level.mines << true;
+    }
+}
+
+void EngineBenchmark::reveal()
+{
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, mines);
+    QFETCH(bool, largest);
+
+    const MineField generated = generatedField(rows, cols, mines);
+    // an empty cell of the smallest or largest opening
+    std::vector<int> sizes(generated.openingCount(), 0);
+    std::vector<int> cells(generated.openingCount(), -1);
+    for (int idx = 0; idx < generated.cellCount(); ++idx) {
+        const int opening = generated.openingOf(idx);
+        if (opening >= 0) {
+            ++sizes[opening];
+            cells[opening] = idx;
+        }
+    }
+    QVERIFY(!sizes.empty());
+    const auto chosen = largest ? std::max_element(sizes.begin(), sizes.end())
+                                : std::min_element(sizes.begin(), sizes.end());
+    const int clicked = cells[chosen - sizes.begin()];
+
+    benchmarkOn(generated, [clicked](MineField& field) {
+        field.reveal(clicked);
+    });
+}
+
+void EngineBenchmark::chord_data()
+{
+    addLevelRows();
+}
+
+void EngineBenchmark::chord()
+{
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, mines);
+
+    // the first digit with safe cells around, revealed and with its mines flagged
+    MineField prepared = generatedField(rows, cols, mines);
+    int digit = -1;
+    for (int idx = 0; idx < prepared.cellCount() && digit < 0; ++idx) {
+        if (prepared.hasMine(idx) || prepared.digit(idx) == 0 || prepared.digit(idx) == prepared.neighbours(idx).count)
+            continue;
+        digit = idx;
+    }
+    QVERIFY(digit >= 0);
+    prepared.reveal(digit);
+    for (int n : prepared.neighbours(digit)) {
+        if (prepared.hasMine(n))
+            prepared.mark(n, false);
+    }
+    prepared.clearChanges();
+
+    benchmarkOn(prepared, [digit](MineField& field) {
+        field.chord(digit);
+    });
+}
+
+void EngineBenchmark::gameOver_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<int>("mines");
+    QTest::addColumn<bool>("won");
+    for (const Level& level : s_levels) {
+        QTest::newRow(qPrintable(QLatin1String(level.name) + QLatin1String(" won")))
+            << level.rows << level.cols << level.mines << true;
+        QTest::newRow(qPrintable(QLatin1String(level.name) + QLatin1String(" lost")))
+            << level.rows << level.cols << level.mines << false;
+    }
+}
+
+void EngineBenchmark::gameOver()
+{
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, mines);
+    QFETCH(bool, won);
+
+    // the last safe cell, flagging all mines, or a mine, revealing all mines
+    int move;
+    MineField prepared = nearlyWonField(rows, cols, mines, &move);
+    if (!won) {
+        prepared = generatedField(rows, cols, mines);
+        move = 0;
+        while (!prepared.hasMine(move))
+            ++move;
+    }
+
+    const MineField::GameResult expected = won ? MineField::GameWon : MineField::GameLost;
+    bool ended = true;
+    benchmarkOn(prepared, [move, expected, &ended](MineField& field) {
+        ended = field.reveal(move) == expected && ended;
+    });
+    QVERIFY(ended);
+}
+
+void EngineBenchmark::reset_data()
+{
+    addLevelRows(" after a game");
+}
+
+void EngineBenchmark::reset()
+{
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, mines);
+
+    int lastMove;
+    const MineField played = nearlyWonField(rows, cols, mines, &lastMove);
+    benchmarkOn(played, [](MineField& field) {
+        field.reset();
+    });
+}
+
+void EngineBenchmark::batchStep_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<int>("mines");
+    QTest::addColumn<int>("actionType");
+    QTest::addColumn<bool>("safe");
+    for (int level = 0; level < 3; ++level) {
+        const Level& l = s_levels[level];
+        // random reveals lose quickly, so they mostly measure starting games
+        QTest::newRow(qPrintable(QLatin1String(l.name) + QLatin1String(" reveal")))
+            << l.rows << l.cols << l.mines << int(BatchEnvironment::Reveal) << false;
+        // reveals of a player who doesn't lose, games are played through
+        QTest::newRow(qPrintable(QLatin1String(l.name) + QLatin1String(" safe reveal")))
+            << l.rows << l.cols << l.mines << int(BatchEnvironment::Reveal) << true;
+        QTest::newRow(qPrintable(QLatin1String(l.name) + QLatin1String(" flag")))
+            << l.rows << l.cols << l.mines << int(BatchEnvironment::ToggleFlag) << false;
+    }
+}
+
+void EngineBenchmark::batchStep()
+{
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, mines);
+    QFETCH(int, actionType);
+    QFETCH(bool, safe);
+
+    const int numBoards = 256;
+    const std::uint64_t seed = 1;
+    const int steps = 1000;
+    BatchEnvironment environment(numBoards, rows, cols, mines, seed);
+    // actions are drawn before timing: safe reveals step by step as the games
+    // go, otherwise a few batches of random actions played again and again
+    std::vector<std::vector<int> > batches;
+    if (safe)
+        batches = safeRevealBatches(numBoards, rows, cols, mines, seed, steps);
+    else {
+        CounterRandom random(1);
+        batches.assign(16, std::vector<int>(numBoards));
+        for (std::vector<int>& actions : batches) {
+            for (int& action : actions)
+                action = actionType*environment.cellCount() + static_cast<int>(random.bounded(environment.cellCount()));
+        }
+    }
+    // warm up, so fields have their memory, then the same games again
+    for (const std::vector<int>& actions : batches)
+        environment.step(actions.data());
+    environment.reset();
+
+    // per board action, the unit targeted by bots
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < steps; ++i)
+        environment.step(batches[i % batches.size()].data());
+    QTest::setBenchmarkResult(qreal(timer.nsecsElapsed()) / (steps*numBoards), QTest::WalltimeNanoseconds);
+    for (int board = 0; board < numBoards; ++board)
+        QVERIFY(!safe || environment.outcomes()[board] != MineField::GameLost);
+}
+
+void EngineBenchmark::noGuessGenerate_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("cols");
+    QTest::addColumn<int>("mines");
+
+    QTest::newRow("Easy") << 9 << 9 << 10;
+    QTest::newRow("Medium") << 16 << 16 << 40;
+    QTest::newRow("Hard") << 16 << 30 << 99;
+}
+
+void EngineBenchmark::noGuessGenerate()
+{
+    QFETCH(int, rows);
+    QFETCH(int, cols);
+    QFETCH(int, mines);
+
+    // what the first click of a no guess level may wait for, on the GUI
+    // thread: it must stay under 100 ms on average
+    const int runs = 20;
+    MineField field;
+    QElapsedTimer timer;
+    timer.start();
+    for (int seed = 0; seed < runs; ++seed) {
+        field.init(rows, cols, mines);
+        NoGuessGenerator::generate(field, field.index(rows/2, cols/2), seed);
+    }
+    const qreal average = qreal(timer.nsecsElapsed()) / runs;
+    QTest::setBenchmarkResult(average, QTest::WalltimeNanoseconds);
+    QVERIFY2(average < 100e6, "searching a field solvable without guessing takes more than 100 ms");
+}
+
+QTEST_GUILESS_MAIN(EngineBenchmark)
+
+#include "enginebenchmark.moc"
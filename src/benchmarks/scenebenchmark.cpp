@@ -0,0 +1,352 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// own
+#include "counterrandom.h"
+#include "minefielditem.h"
+#include "renderstats.h"
+#include "scene.h"
+// KDEGames
+#include <KgThemeProvider>
+// Qt
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QMouseEvent>
+#include <QSet>
+#include <QSignalSpy>
+#include <QTest>
+// Std
+#include <functional>
+
+namespace
+{
+
+struct Level
+{
+    const char* name;
+    int rows;
+    int cols;
+    int mines;
+};
+
+/**
+ * Standard levels and a custom field scrolled in the view
+ */
+const Level s_levels[] = {
+    { "Easy", 9, 9, 10 },
+    { "Medium", 16, 16, 40 },
+    { "Hard", 16, 30, 99 },
+    { "Custom 100x100", 100, 100, 1500 }
+};
+
+enum Metric { PaintTime, SpriteRequests, ItemsCreated, ItemsDeleted };
+
+const char* const s_metricNames[] = { "paint", "sprites", "items created", "items deleted" };
+
+/**
+ * Adds level and metric columns and a row per level and metric.
+ * Each row replays the same actions, reporting one of their metrics
+ */
+void addMetricRows()
+{
+    QTest::addColumn<int>("level");
+    QTest::addColumn<int>("metric");
+    for(int level = 0; level < int(sizeof(s_levels)/sizeof(s_levels[0])); ++level)
+        for(int metric = PaintTime; metric <= ItemsDeleted; ++metric)
+            QTest::newRow(qPrintable(QLatin1String(s_levels[level].name) + QLatin1String(": ")
+                                     + QLatin1String(s_metricNames[metric])))
+                << level << metric;
+}
+
+/**
+ * View timing its paint events, each is a frame shown to the player
+ */
+class TimedView : public KMinesView
+{
+public:
+    explicit TimedView(KMinesScene* scene)
+        : KMinesView(scene, nullptr)
+    {
+    }
+    qint64 paintTime = 0;
+    int frames = 0;
+protected:
+    void paintEvent(QPaintEvent* event) override
+    {
+        QElapsedTimer timer;
+        timer.start();
+        KMinesView::paintEvent(event);
+        paintTime += timer.nsecsElapsed();
+        ++frames;
+    }
+};
+
+/**
+ * A scene and its view shown offscreen, playing a game of level
+ * generated from a fixed seed
+ */
+class Fixture
+{
+public:
+    explicit Fixture(const Level& level)
+        : m_level(level), m_scene(nullptr), m_view(&m_scene)
+    {
+        m_scene.setSeed(1);
+        QObject::connect(&m_scene, &KMinesScene::gameOver, [this]() { m_gameOver = true; });
+        for(QGraphicsItem* item : m_scene.items())
+            if(MineFieldItem* field = qobject_cast<MineFieldItem*>(item->toGraphicsObject()))
+                m_field = field;
+
+        m_view.resize(1024, 768);
+        m_view.show();
+        QTest::qWaitForWindowExposed(&m_view);
+        newGame();
+    }
+
+    KMinesScene& scene() { return m_scene; }
+    TimedView& view() { return m_view; }
+    int cellCount() const { return m_level.rows * m_level.cols; }
+    bool isGameOver() const { return m_gameOver; }
+
+    void newGame()
+    {
+        m_gameOver = false;
+        m_scene.startNewGame(m_level.rows, m_level.cols, m_level.mines);
+        frame();
+    }
+
+    /**
+     * Lets the scene and the view handle what is pending, which paints a frame
+     * if anything changed. Scene updates are queued, then the view repaints
+     * on an update request
+     */
+    void frame()
+    {
+        for(int i = 0; i < 3; ++i)
+            QCoreApplication::processEvents();
+    }
+
+    /**
+     * Sends a mouse event over cell at idx to the view, like the player would,
+     * and shows the next frame
+     */
+    void mouse(QEvent::Type type, int idx, Qt::MouseButton button, Qt::MouseButtons buttons)
+    {
+        // +1 - because of border on each side
+        const qreal cellSize = m_field->boundingRect().width() / (m_level.cols + 2);
+        const QPointF cellCenter((idx % m_level.cols + 1.5) * cellSize, (idx / m_level.cols + 1.5) * cellSize);
+        const QPoint pos = m_view.mapFromScene(m_field->mapToScene(cellCenter));
+        QMouseEvent event(type, pos, m_view.viewport()->mapToGlobal(pos), button, buttons, Qt::NoModifier);
+        QCoreApplication::sendEvent(m_view.viewport(), &event);
+        frame();
+    }
+
+    void click(int idx, Qt::MouseButton button)
+    {
+        mouse(QEvent::MouseButtonPress, idx, button, button);
+        mouse(QEvent::MouseButtonRelease, idx, button, Qt::NoButton);
+    }
+
+    /**
+     * Presses the middle button on idx and drags it over the next cells
+     * of the row, chording where it is released
+     */
+    void dragChord(int idx)
+    {
+        mouse(QEvent::MouseButtonPress, idx, Qt::MiddleButton, Qt::MiddleButton);
+        const int last = qMin(idx + 3, idx - idx % m_level.cols + m_level.cols - 1);
+        for(int next = idx + 1; next <= last; ++next)
+            mouse(QEvent::MouseMove, next, Qt::NoButton, Qt::MiddleButton);
+        mouse(QEvent::MouseButtonRelease, last, Qt::MiddleButton, Qt::NoButton);
+    }
+
+private:
+    Level m_level;
+    KMinesScene m_scene;
+    TimedView m_view;
+    MineFieldItem* m_field = nullptr;
+    bool m_gameOver = false;
+};
+
+QSet<QGraphicsItem*> itemsOf(const QGraphicsScene& scene)
+{
+    QSet<QGraphicsItem*> items;
+    for(QGraphicsItem* item : scene.items())
+        items.insert(item);
+    return items;
+}
+
+/**
+ * Runs action(0) up to action(count - 1) and reports metric of them,
+ * per frame for the paint time and per action for the others.
+ * QVERIFY in action only leaves action, so it stops at the first failure
+ */
+void measure(Fixture& fixture, Metric metric, int count, const std::function<void(int)>& action)
+{
+    const qint64 paintTime = fixture.view().paintTime;
+    const int frames = fixture.view().frames;
+    const int spriteRequests = RenderStats::spriteRequests();
+    int created = 0;
+    int deleted = 0;
+    for(int i = 0; i < count; ++i)
+    {
+        const QSet<QGraphicsItem*> before = itemsOf(fixture.scene());
+        action(i);
+        if(QTest::currentTestFailed())
+            return;
+        const QSet<QGraphicsItem*> after = itemsOf(fixture.scene());
+        created += (after - before).size();
+        deleted += (before - after).size();
+    }
+
+    switch(metric)
+    {
+    case PaintTime:
+    {
+        const int newFrames = fixture.view().frames - frames;
+        QTest::setBenchmarkResult(newFrames > 0 ? qreal(fixture.view().paintTime - paintTime) / newFrames : 0,
+                                  QTest::WalltimeNanoseconds);
+        break;
+    }
+    case SpriteRequests:
+        QTest::setBenchmarkResult(qreal(RenderStats::spriteRequests() - spriteRequests) / count, QTest::Events);
+        break;
+    case ItemsCreated:
+        QTest::setBenchmarkResult(qreal(created) / count, QTest::Events);
+        break;
+    case ItemsDeleted:
+        QTest::setBenchmarkResult(qreal(deleted) / count, QTest::Events);
+        break;
+    }
+}
+
+}
+
+/**
+ * Benchmarks of the scene as the player sees it: time to paint a frame,
+ * sprites requested from KGameRenderer and graphics items created or
+ * deleted by input, resizes and theme switches. They run offscreen
+ * unless QT_QPA_PLATFORM tells otherwise
+ */
+class SceneBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase()
+    {
+        KMinesScene scene(nullptr);
+        if(scene.renderer().themeProvider()->themes().isEmpty())
+            QSKIP("KMines themes are not installed");
+    }
+
+    void input_data()
+    {
+        addMetricRows();
+    }
+
+    /**
+     * Clicks, flags and middle button drags over random cells,
+     * starting a new game when one is over
+     */
+    void input()
+    {
+        QFETCH(int, level);
+        QFETCH(int, metric);
+        Fixture fixture(s_levels[level]);
+        CounterRandom random(1);
+
+        measure(fixture, Metric(metric), 200, [&fixture, &random](int step) {
+            if(fixture.isGameOver())
+                fixture.newGame();
+            const int idx = static_cast<int>(random.bounded(fixture.cellCount()));
+            switch(step % 4)
+            {
+            case 0:
+            case 1:
+                fixture.click(idx, Qt::LeftButton);
+                break;
+            case 2:
+                fixture.dragChord(idx);
+                break;
+            default:
+                fixture.click(idx, Qt::RightButton);
+                break;
+            }
+        });
+    }
+
+    void resizeStorm_data()
+    {
+        addMetricRows();
+    }
+
+    /**
+     * Resizes the view a dozen times in a row, like dragging a window
+     * border, then waits until the scene is laid out for the final size
+     */
+    void resizeStorm()
+    {
+        QFETCH(int, level);
+        QFETCH(int, metric);
+        Fixture fixture(s_levels[level]);
+        QSignalSpy resized(&fixture.scene(), &KMinesScene::resized);
+
+        measure(fixture, Metric(metric), 5, [&fixture, &resized](int storm) {
+            resized.clear();
+            for(int i = 0; i < 12; ++i)
+            {
+                // growing then shrinking storms
+                const int step = storm % 2 == 0 ? i : 11 - i;
+                fixture.view().resize(800 + 40 * step, 600 + 30 * step);
+                fixture.frame();
+            }
+            QVERIFY(QTest::qWaitFor([&resized]() { return !resized.isEmpty(); }, 5000));
+            fixture.frame();
+        });
+    }
+
+    void themeSwitch_data()
+    {
+        addMetricRows();
+    }
+
+    /**
+     * Switches to each installed theme in turn, as the settings dialog does
+     */
+    void themeSwitch()
+    {
+        QFETCH(int, level);
+        QFETCH(int, metric);
+        Fixture fixture(s_levels[level]);
+        KgThemeProvider* provider = fixture.scene().renderer().themeProvider();
+        const QList<const KgTheme*> themes = provider->themes();
+        if(themes.size() < 2)
+            QSKIP("Switching themes needs at least two of them installed");
+
+        measure(fixture, Metric(metric), 2 * themes.size(), [&fixture, provider, &themes](int i) {
+            provider->setCurrentTheme(themes.at((i + 1) % themes.size()));
+            // what KMinesMainWindow::loadSettings() does
+            fixture.view().resetCachedContent();
+            fixture.scene().resizeScene(fixture.view().viewport()->width(), fixture.view().viewport()->height());
+            fixture.frame();
+        });
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    // no display needed, frames don't depend on a window manager
+    if(!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication::setAttribute(Qt::AA_Use96Dpi, true);
+    QApplication app(argc, argv);
+    // themes and settings of the game
+    QApplication::setApplicationName(QStringLiteral("kmines"));
+    SceneBenchmark benchmark;
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "scenebenchmark.moc"
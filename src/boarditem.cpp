@@ -0,0 +1,355 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "boarditem.h"
+
+// own
+#include "cellatlas.h"
+#include "minefield.h"
+// Qt
+#include <QElapsedTimer>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QTimerEvent>
+#include <QWidget>
+// Std
+#include <algorithm>
+#include <limits>
+
+BoardItem::BoardItem(const CellAtlas* atlas, const MineField* field, QGraphicsItem* parent)
+    : QGraphicsObject(parent), m_atlas(atlas), m_field(field)
+{
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+    // mouse is handled by MineFieldItem
+    setAcceptedMouseButtons(Qt::NoButton);
+    // a cell and its neighbours, pressing never allocates
+    m_pressed.reserve(9);
+    // in device pixels, until the first paint tells the viewport size
+    m_tiles.setMaxCost(8*1024*1024);
+}
+
+void BoardItem::setCellSize(int cellSize)
+{
+    prepareGeometryChange();
+    m_cellSize = cellSize;
+    clearTiles();
+    // tiles of another size, the budget is computed again
+    m_viewSize = QSize();
+    update();
+}
+
+void BoardItem::updateCells(const std::vector<int>& cells, int origin)
+{
+    if(cells.empty())
+        return;
+
+    const size_t first = m_pending.size();
+    m_pending.resize(first + cells.size());
+    if(origin < 0)
+        std::copy(cells.begin(), cells.end(), m_pending.begin() + first);
+    else
+    {
+        // counting sort by distance to origin: rings of cells ripple away from it
+        const int originRow = m_field->rowOf(origin);
+        const int originCol = m_field->colOf(origin);
+        const auto distance = [this, originRow, originCol](int idx) {
+            return qMax(qAbs(m_field->rowOf(idx) - originRow), qAbs(m_field->colOf(idx) - originCol));
+        };
+        std::vector<size_t> starts(qMax(m_field->rowCount(), m_field->columnCount()) + 1, 0);
+        for (int idx : cells) {
+            ++starts[distance(idx) + 1];
+        }
+        starts[0] = first;
+        for(size_t d = 1; d < starts.size(); ++d)
+            starts[d] += starts[d - 1];
+        for (int idx : cells) {
+            m_pending[starts[distance(idx)]++] = idx;
+        }
+    }
+
+    // the first batch right away, so small changes are shown at once
+    showPendingCells();
+    if(m_nextPending < m_pending.size() && !m_pendingTimer.isActive())
+        m_pendingTimer.start(FRAME_INTERVAL, this);
+}
+
+void BoardItem::showPendingCells()
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+    int top = m_field->rowCount(), bottom = -1;
+    int left = m_field->columnCount(), right = -1;
+    // the budget is checked between chunks, a cell costs a couple of blits
+    const size_t chunk = 256;
+    while(m_nextPending < m_pending.size() && !elapsed.hasExpired(FRAME_BUDGET))
+    {
+        const size_t end = qMin(m_nextPending + chunk, m_pending.size());
+        for(; m_nextPending < end; ++m_nextPending)
+        {
+            const int idx = m_pending[m_nextPending];
+            m_looks[idx] = CellAtlas::appearance(m_field, idx, m_field->state(idx));
+            markDirty(idx);
+            const int row = m_field->rowOf(idx);
+            const int col = m_field->colOf(idx);
+            top = qMin(top, row);
+            bottom = qMax(bottom, row);
+            left = qMin(left, col);
+            right = qMax(right, col);
+        }
+        flushDirtyCells();
+    }
+
+    // a single update of the rect covering them all
+    if(bottom >= 0)
+        update(cellRect(top, left).united(cellRect(bottom, right)));
+    if(m_nextPending == m_pending.size())
+    {
+        m_pending.clear();
+        m_nextPending = 0;
+        m_pendingTimer.stop();
+    }
+}
+
+void BoardItem::timerEvent(QTimerEvent* event)
+{
+    if(event->timerId() == m_pendingTimer.timerId())
+        showPendingCells();
+    else
+        QGraphicsObject::timerEvent(event);
+}
+
+void BoardItem::reset()
+{
+    m_pending.clear();
+    m_nextPending = 0;
+    m_pendingTimer.stop();
+    // the model was just reset, every cell is released
+    m_looks.assign(m_field->cellCount(), KMinesState::Released);
+
+    m_pressed.clear();
+    m_hint = -1;
+    clearTiles();
+    update();
+}
+
+void BoardItem::press(int idx)
+{
+    if(m_field->state(idx) == KMinesState::Released && !m_pressed.contains(idx))
+    {
+        m_pressed.append(idx);
+        markDirty(idx);
+        update(cellRect(m_field->rowOf(idx), m_field->colOf(idx)));
+    }
+}
+
+void BoardItem::undoPress(int idx)
+{
+    if(m_pressed.removeOne(idx))
+    {
+        markDirty(idx);
+        update(cellRect(m_field->rowOf(idx), m_field->colOf(idx)));
+    }
+}
+
+void BoardItem::setHint(int idx)
+{
+    if(m_hint >= 0)
+    {
+        markDirty(m_hint);
+        update(cellRect(m_field->rowOf(m_hint), m_field->colOf(m_hint)));
+    }
+    m_hint = idx;
+    if(m_hint >= 0)
+    {
+        markDirty(m_hint);
+        update(cellRect(m_field->rowOf(m_hint), m_field->colOf(m_hint)));
+    }
+}
+
+QRectF BoardItem::boundingRect() const
+{
+    // +2 - because of border on each side
+    return QRectF(0, 0, m_cellSize*(m_field->columnCount()+2), m_cellSize*(m_field->rowCount()+2));
+}
+
+QRectF BoardItem::cellRect(int row, int col) const
+{
+    return QRectF((col+1)*m_cellSize, (row+1)*m_cellSize, m_cellSize, m_cellSize);
+}
+
+void BoardItem::clearTiles()
+{
+    m_tiles.clear();
+    m_dirtyCells.clear();
+    // +1 - because of border on each side
+    m_tileCols = (m_field->columnCount() + 1) / TILE_CELLS + 1;
+}
+
+void BoardItem::updateTileBudget(const QSize& viewSize, qreal devicePixelRatio)
+{
+    if(viewSize == m_viewSize && devicePixelRatio == m_devicePixelRatio)
+        return;
+    m_viewSize = viewSize;
+    m_devicePixelRatio = devicePixelRatio;
+
+    // twice the tiles covering the viewport, partly visible ones included.
+    // Costs are in device pixels, four times as many at a ratio of 2
+    const qint64 tileSize = TILE_CELLS * m_cellSize;
+    const qint64 tiles = (viewSize.width() / tileSize + 2) * (viewSize.height() / tileSize + 2);
+    const qreal cost = 2 * tiles * tileSize * tileSize * devicePixelRatio * devicePixelRatio;
+    m_tiles.setMaxCost(static_cast<int>(qMin<qreal>(cost, std::numeric_limits<int>::max())));
+}
+
+int BoardItem::tileOf(int idx) const
+{
+    // +1 - because of border on each side
+    return ((m_field->rowOf(idx) + 1) / TILE_CELLS) * m_tileCols + (m_field->colOf(idx) + 1) / TILE_CELLS;
+}
+
+void BoardItem::markDirty(int idx)
+{
+    m_dirtyCells.push_back(idx);
+    // lots of changes out of sight, composing tiles again is cheaper
+    if(m_dirtyCells.size() > static_cast<size_t>(m_field->cellCount()))
+        clearTiles();
+}
+
+void BoardItem::flushDirtyCells()
+{
+    if(m_dirtyCells.empty())
+        return;
+
+    std::sort(m_dirtyCells.begin(), m_dirtyCells.end(), [this](int a, int b) {
+        const int tileA = tileOf(a);
+        const int tileB = tileOf(b);
+        return tileA < tileB || (tileA == tileB && a < b);
+    });
+    const std::vector<int>::iterator end = std::unique(m_dirtyCells.begin(), m_dirtyCells.end());
+
+    // one painter per tile, tiles not cached are composed when painted
+    std::vector<int>::iterator it = m_dirtyCells.begin();
+    while(it != end)
+    {
+        const int tile = tileOf(*it);
+        const std::vector<int>::iterator tileEnd = std::find_if(it, end, [this, tile](int idx) {
+            return tileOf(idx) != tile;
+        });
+        if(QPixmap* pixmap = m_tiles.object(tile))
+        {
+            const int firstRow = (tile / m_tileCols) * TILE_CELLS;
+            const int firstCol = (tile % m_tileCols) * TILE_CELLS;
+            QPainter painter(pixmap);
+            // replace the previous look, sprites may be translucent
+            painter.setCompositionMode(QPainter::CompositionMode_Source);
+            for(; it != tileEnd; ++it)
+                paintCell(&painter, m_field->rowOf(*it), m_field->colOf(*it), firstRow, firstCol);
+        }
+        it = tileEnd;
+    }
+    m_dirtyCells.clear();
+}
+
+void BoardItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    if(m_cellSize <= 0)
+        return;
+    // no widget when rendered to an image, the budget stays as it is
+    if(widget)
+        updateTileBudget(widget->size(), painter->device()->devicePixelRatioF());
+    flushDirtyCells();
+
+    // only tiles intersecting the exposed rect, blitting only what is exposed
+    const QRectF exposed = option->exposedRect.intersected(boundingRect());
+    if(exposed.isEmpty())
+        return;
+    const int tileSize = TILE_CELLS * m_cellSize;
+    const int firstTileRow = qMax(0, static_cast<int>(exposed.top()/tileSize));
+    const int lastTileRow = qMin((m_field->rowCount() + 1) / TILE_CELLS, static_cast<int>(exposed.bottom()/tileSize));
+    const int firstTileCol = qMax(0, static_cast<int>(exposed.left()/tileSize));
+    const int lastTileCol = qMin(m_tileCols - 1, static_cast<int>(exposed.right()/tileSize));
+
+    for(int tileRow = firstTileRow; tileRow <= lastTileRow; ++tileRow)
+        for(int tileCol = firstTileCol; tileCol <= lastTileCol; ++tileCol)
+        {
+            const int tile = tileRow * m_tileCols + tileCol;
+            QPixmap composed;
+            const QPixmap* pixmap = m_tiles.object(tile);
+            if(!pixmap)
+            {
+                composed = composeTile(tileRow, tileCol);
+                // width and height count device pixels
+                m_tiles.insert(tile, new QPixmap(composed), composed.width() * composed.height());
+                pixmap = &composed;
+            }
+            const QRectF tileRect(QPointF(tileCol * tileSize, tileRow * tileSize), pixmap->size());
+            const QRectF target = tileRect.intersected(exposed);
+            painter->drawPixmap(target, *pixmap, target.translated(-tileRect.topLeft()));
+        }
+}
+
+QPixmap BoardItem::composeTile(int tileRow, int tileCol) const
+{
+    // +2 - because of border on each side
+    const int firstRow = tileRow * TILE_CELLS;
+    const int firstCol = tileCol * TILE_CELLS;
+    const int numRows = qMin(m_field->rowCount() + 2 - firstRow, int(TILE_CELLS));
+    const int numCols = qMin(m_field->columnCount() + 2 - firstCol, int(TILE_CELLS));
+
+    QPixmap pixmap(numCols * m_cellSize, numRows * m_cellSize);
+    pixmap.fill(Qt::transparent);
+    QPainter painter(&pixmap);
+    for(int row = firstRow; row < firstRow + numRows; ++row)
+        for(int col = firstCol; col < firstCol + numCols; ++col)
+        {
+            if(row == 0 || row == m_field->rowCount() + 1 || col == 0 || col == m_field->columnCount() + 1)
+                paintBorder(&painter, row, col, firstRow, firstCol);
+            else
+                paintCell(&painter, row - 1, col - 1, firstRow, firstCol);
+        }
+    return pixmap;
+}
+
+void BoardItem::paintCell(QPainter* painter, int row, int col, int firstRow, int firstCol) const
+{
+    const int idx = m_field->index(row, col);
+    int look = m_looks[idx];
+    // pressed and hint looks only make sense for cells which can be revealed
+    if(look == KMinesState::Released)
+    {
+        if(m_pressed.contains(idx))
+            look = KMinesState::Pressed;
+        else if(idx == m_hint)
+            look = KMinesState::Hint;
+    }
+
+    painter->drawPixmap((col + 1 - firstCol) * m_cellSize, (row + 1 - firstRow) * m_cellSize,
+                        m_atlas->pixmap(look));
+}
+
+void BoardItem::paintBorder(QPainter* painter, int row, int col, int firstRow, int firstCol) const
+{
+    const int lastRow = m_field->rowCount() + 1;
+    const int lastCol = m_field->columnCount() + 1;
+    KMinesState::BorderElement element;
+    if(row == 0 && col == 0)
+        element = KMinesState::BorderCornerNW;
+    else if(row == 0 && col == lastCol)
+        element = KMinesState::BorderCornerNE;
+    else if(row == lastRow && col == 0)
+        element = KMinesState::BorderCornerSW;
+    else if(row == lastRow && col == lastCol)
+        element = KMinesState::BorderCornerSE;
+    else if(row == 0)
+        element = KMinesState::BorderNorth;
+    else if(row == lastRow)
+        element = KMinesState::BorderSouth;
+    else if(col == 0)
+        element = KMinesState::BorderWest;
+    else
+        element = KMinesState::BorderEast;
+
+    painter->drawPixmap((col - firstCol) * m_cellSize, (row - firstRow) * m_cellSize, m_atlas->borderPixmap(element));
+}
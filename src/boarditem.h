@@ -0,0 +1,153 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef BOARDITEM_H
+#define BOARDITEM_H
+
+// Qt
+#include <QBasicTimer>
+#include <QCache>
+#include <QGraphicsObject>
+#include <QPixmap>
+#include <QVector>
+// Std
+#include <vector>
+
+class CellAtlas;
+class MineField;
+
+/**
+ * Graphics item painting a whole MineField with its border.
+ *
+ * The field is composed into tiles of TILE_CELLS x TILE_CELLS cells
+ * (border included), cached while they are visible. A changed cell is
+ * drawn again into its cached tile only, and the view repaints the
+ * changed area with tile blits, so even a large opening or all mines
+ * shown at game over are cheap to paint.
+ *
+ * Cells show the look they had when last updated, so thousands of
+ * changes are shown in batches fitting a frame budget, rippling
+ * away from the cell of the move, while the model is already up to date.
+ */
+class BoardItem : public QGraphicsObject
+{
+    Q_OBJECT
+public:
+    BoardItem(const CellAtlas* atlas, const MineField* field, QGraphicsItem* parent);
+    /**
+     * Sets cell size, the atlas must be rendered at this size.
+     * Also drops cached tiles, e.g. after a theme change
+     */
+    void setCellSize(int cellSize);
+    /**
+     * Shows the model state of the given cells. Some of them are shown
+     * right away, the others in the next frames, the nearest to origin
+     * first. origin is -1 if the order doesn't matter
+     */
+    void updateCells(const std::vector<int>& cells, int origin = -1);
+    /**
+     * Shows all cells released right away and forgets pressed and hint
+     * looks and cached tiles, after a new game or reset of the model.
+     * This is a single fill and a single repaint
+     */
+    void reset();
+    /**
+     * Shows the cell at idx as pressed if it can be revealed
+     */
+    void press(int idx);
+    /**
+     * Shows the cell at idx as released again
+     */
+    void undoPress(int idx);
+    /**
+     * Moves the hint look to cell at idx, -1 to remove it
+     */
+    void setHint(int idx);
+    /**
+     * Reimplemented from QGraphicsItem
+     */
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
+
+    /**
+     * Size of tiles, in cells
+     */
+    static const int TILE_CELLS = 16;
+    /**
+     * Time given to showing changed cells in each frame, in milliseconds
+     */
+    static const int FRAME_BUDGET = 4;
+    static const int FRAME_INTERVAL = 16;
+protected:
+    void timerEvent(QTimerEvent* event) override;
+private:
+    /**
+     * Shows pending cells until the frame budget is spent
+     */
+    void showPendingCells();
+    QRectF cellRect(int row, int col) const;
+    /**
+     * Drops cached tiles, they are composed again when painted
+     */
+    void clearTiles();
+    /**
+     * Sizes the tile cache for a viewport of viewSize at devicePixelRatio
+     */
+    void updateTileBudget(const QSize& viewSize, qreal devicePixelRatio);
+    /**
+     * Index of the tile holding cell at idx
+     */
+    int tileOf(int idx) const;
+    /**
+     * Remembers cell at idx must be drawn again into its cached tile
+     */
+    void markDirty(int idx);
+    /**
+     * Draws cells marked dirty into their cached tiles
+     */
+    void flushDirtyCells();
+    QPixmap composeTile(int tileRow, int tileCol) const;
+    /**
+     * Draws cell (row,col) in a tile starting at padded (firstRow, firstCol)
+     */
+    void paintCell(QPainter* painter, int row, int col, int firstRow, int firstCol) const;
+    void paintBorder(QPainter* painter, int row, int col, int firstRow, int firstCol) const;
+
+    const CellAtlas* m_atlas;
+    const MineField* m_field;
+    int m_cellSize = 0;
+    /**
+     * Composed tiles, indexed by tileRow*m_tileCols + tileCol
+     */
+    QCache<int, QPixmap> m_tiles;
+    int m_tileCols = 0;
+    /**
+     * Viewport the tile cache is sized for, see updateTileBudget()
+     */
+    QSize m_viewSize;
+    qreal m_devicePixelRatio = 0;
+    /**
+     * Cells changed since the last paint, duplicates allowed
+     */
+    std::vector<int> m_dirtyCells;
+    /**
+     * Shown look of every cell, see CellAtlas::appearance()
+     */
+    std::vector<quint8> m_looks;
+    /**
+     * Changed cells not shown yet, from m_nextPending on
+     */
+    std::vector<int> m_pending;
+    size_t m_nextPending = 0;
+    QBasicTimer m_pendingTimer;
+    /**
+     * Cells shown pressed, a handful at most
+     */
+    QVector<int> m_pressed;
+    int m_hint = -1;
+};
+
+#endif
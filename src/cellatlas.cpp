@@ -0,0 +1,124 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "cellatlas.h"
+
+// own
+#include "minefield.h"
+#include "renderstats.h"
+// KDEGames
+#include <KGameRenderer>
+// Qt
+#include <QPainter>
+
+const char* const CellAtlas::s_spriteKeys[APPEARANCE_COUNT][MAX_LAYERS] = {
+    // in CellState order
+    { "cell_up" },
+    { "cell_down" },
+    { "cell_down" },
+    { "cell_up", "question" },
+    { "cell_up", "flag" },
+    { "cell_down", "mine", "error" },
+    { "cell_up", "hint" },
+    // revealed digits
+    { "cell_down", "arabicOne" },
+    { "cell_down", "arabicTwo" },
+    { "cell_down", "arabicThree" },
+    { "cell_down", "arabicFour" },
+    { "cell_down", "arabicFive" },
+    { "cell_down", "arabicSix" },
+    { "cell_down", "arabicSeven" },
+    { "cell_down", "arabicEight" },
+    // revealed mines
+    { "cell_down", "mine" },
+    { "cell_down", "explosion", "mine" }
+};
+
+const char* const CellAtlas::s_borderKeys[BORDER_ELEMENT_COUNT] = {
+    // in BorderElement order
+    "border.edge.north",
+    "border.edge.south",
+    "border.edge.east",
+    "border.edge.west",
+    "border.outsideCorner.nw",
+    "border.outsideCorner.sw",
+    "border.outsideCorner.ne",
+    "border.outsideCorner.se"
+};
+
+CellAtlas::CellAtlas(KGameRenderer* renderer)
+    : m_renderer(renderer), m_pixmaps(APPEARANCE_COUNT), m_borderPixmaps(BORDER_ELEMENT_COUNT)
+{
+}
+
+bool CellAtlas::setCellSize(int cellSize)
+{
+    if(cellSize == m_cellSize && m_renderer->theme() == m_theme)
+        return false;
+    m_cellSize = cellSize;
+    m_theme = m_renderer->theme();
+
+    for(int i = 0; i < APPEARANCE_COUNT; ++i)
+        m_pixmaps[i] = render(s_spriteKeys[i], MAX_LAYERS);
+    for(int i = 0; i < BORDER_ELEMENT_COUNT; ++i)
+        m_borderPixmaps[i] = render(&s_borderKeys[i], 1);
+    return true;
+}
+
+int CellAtlas::cellSize() const
+{
+    return m_cellSize;
+}
+
+int CellAtlas::appearance(const MineField* field, int idx, KMinesState::CellState state)
+{
+    if(state != KMinesState::Revealed)
+        return state;
+    if(field->digit(idx) != 0)
+        return FIRST_DIGIT + field->digit(idx) - 1;
+    if(field->hasMine(idx))
+        return field->isExploded(idx) ? EXPLODED_MINE : MINE;
+    return KMinesState::Revealed;
+}
+
+const QPixmap& CellAtlas::pixmap(int appearance) const
+{
+    return m_pixmaps.at(appearance);
+}
+
+const QPixmap& CellAtlas::borderPixmap(KMinesState::BorderElement e) const
+{
+    return m_borderPixmaps.at(e);
+}
+
+QStringList CellAtlas::spriteKeys()
+{
+    QStringList keys;
+    for(int i = 0; i < APPEARANCE_COUNT; ++i)
+        for(int layer = 0; layer < MAX_LAYERS && s_spriteKeys[i][layer]; ++layer)
+            keys.append(QString::fromLatin1(s_spriteKeys[i][layer]));
+    for(int i = 0; i < BORDER_ELEMENT_COUNT; ++i)
+        keys.append(QString::fromLatin1(s_borderKeys[i]));
+    keys.removeDuplicates();
+    return keys;
+}
+
+QPixmap CellAtlas::render(const char* const* keys, int count) const
+{
+    if(m_cellSize <= 0)
+        return QPixmap();
+
+    const QSize size(m_cellSize, m_cellSize);
+    QPixmap pixmap(size);
+    pixmap.fill(Qt::transparent);
+    QPainter painter(&pixmap);
+    for(int i = 0; i < count && keys[i]; ++i)
+    {
+        RenderStats::countSpriteRequest();
+        painter.drawPixmap(0, 0, m_renderer->spritePixmap(QString::fromLatin1(keys[i]), size));
+    }
+    return pixmap;
+}
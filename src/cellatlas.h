@@ -0,0 +1,98 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef CELLATLAS_H
+#define CELLATLAS_H
+
+// own
+#include "commondefs.h"
+// Qt
+#include <QPixmap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class KGameRenderer;
+class KgTheme;
+class MineField;
+
+/**
+ * Pixmaps of every look a cell or a border tile can have,
+ * rendered once per cell size and theme.
+ *
+ * A cell look is a composite of theme sprites (e.g. "cell_down"
+ * with "explosion" and "mine" over it), so showing a cell is a
+ * single pixmap, whatever its state.
+ */
+class CellAtlas
+{
+public:
+    explicit CellAtlas(KGameRenderer* renderer);
+    /**
+     * Renders all looks at cellSize, unless they are already
+     * rendered at this size with the current theme.
+     * @return true if pixmaps changed
+     */
+    bool setCellSize(int cellSize);
+    /**
+     * @return size of pixmaps, in both dimensions
+     */
+    int cellSize() const;
+    /**
+     * @return look of cell at idx of field shown in given state.
+     * The state may differ from the model one for pressed and hint looks
+     */
+    static int appearance(const MineField* field, int idx, KMinesState::CellState state);
+    /**
+     * @return pixmap of a look returned by appearance()
+     */
+    const QPixmap& pixmap(int appearance) const;
+    /**
+     * @return pixmap of border element e
+     */
+    const QPixmap& borderPixmap(KMinesState::BorderElement e) const;
+    /**
+     * @return all sprite keys rendered at cell size, without duplicates
+     */
+    static QStringList spriteKeys();
+
+    /**
+     * Looks of unrevealed cells and of revealed empty ones are indexed
+     * by their CellState, revealed digits, mines and explosions follow
+     */
+    static const int FIRST_DIGIT = KMinesState::Hint + 1;
+    static const int MINE = FIRST_DIGIT + 8;
+    static const int EXPLODED_MINE = MINE + 1;
+    static const int APPEARANCE_COUNT = EXPLODED_MINE + 1;
+    static const int BORDER_ELEMENT_COUNT = KMinesState::BorderCornerSE + 1;
+    /**
+     * Maximal number of sprites composing a look
+     */
+    static const int MAX_LAYERS = 3;
+private:
+    /**
+     * Sprite keys, bottom to top, composing each look, null terminated
+     * when shorter than MAX_LAYERS. Indexed by appearance
+     */
+    static const char* const s_spriteKeys[APPEARANCE_COUNT][MAX_LAYERS];
+    /**
+     * Sprite keys indexed by BorderElement
+     */
+    static const char* const s_borderKeys[BORDER_ELEMENT_COUNT];
+
+    QPixmap render(const char* const* keys, int count) const;
+
+    KGameRenderer* m_renderer;
+    /**
+     * Theme the pixmaps were rendered with
+     */
+    const KgTheme* m_theme = nullptr;
+    int m_cellSize = 0;
+    QVector<QPixmap> m_pixmaps;
+    QVector<QPixmap> m_borderPixmaps;
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "batchenvironment.h"
+
+// own
+#include "counterrandom.h"
+#include "workstealingpool.h"
+// Std
+#include <algorithm>
+
+const std::uint8_t BatchEnvironment::INVALID_ACTION;
+
+BatchEnvironment::BatchEnvironment(int numBoards, int numRows, int numCols, int numMines, std::uint64_t seed)
+    : m_numBoards(numBoards), m_numRows(numRows), m_numCols(numCols), m_numMines(numMines), m_seed(seed),
+      m_fields(numBoards), m_games(numBoards), m_revealed(static_cast<size_t>(numBoards)*cellCount()),
+      m_digits(m_revealed.size()), m_flags(m_revealed.size()), m_outcomes(numBoards), m_revealedCounts(numBoards)
+{
+    reset();
+}
+
+void BatchEnvironment::reset()
+{
+    std::fill(m_games.begin(), m_games.end(), 0);
+    std::fill(m_outcomes.begin(), m_outcomes.end(), MineField::GameContinues);
+    std::fill(m_revealedCounts.begin(), m_revealedCounts.end(), 0);
+    for (int board = 0; board < m_numBoards; ++board)
+        startGame(board);
+}
+
+void BatchEnvironment::step(const int* actions, WorkStealingPool* pool)
+{
+    if (!pool)
+    {
+        for (int board = 0; board < m_numBoards; ++board)
+            stepBoard(board, actions[board]);
+        return;
+    }
+    // boards only write their own slices of the planes
+    pool->run(m_numBoards, [this, actions](int, int board) {
+        stepBoard(board, actions[board]);
+    });
+}
+
+void BatchEnvironment::stepBoard(int board, int action)
+{
+    if (action < 0 || action >= actionCount())
+    {
+        m_outcomes[board] = INVALID_ACTION;
+        m_revealedCounts[board] = 0;
+        return;
+    }
+    MineField& field = m_fields[board];
+    const int cells = cellCount();
+    const int idx = action % cells;
+    MineField::GameResult result = MineField::GameContinues;
+    switch (action / cells)
+    {
+    case Reveal:
+        if (!field.isGenerated() && field.state(idx) == KMinesState::Released)
+            field.generate(idx, CounterRandom(CounterRandom(m_seed).at(board)).at(m_games[board]));
+        result = field.reveal(idx);
+        break;
+    case ToggleFlag:
+        field.mark(idx, false);
+        break;
+    case Chord:
+        result = field.chord(idx);
+        break;
+    }
+
+    m_outcomes[board] = static_cast<std::uint8_t>(result);
+    if (result != MineField::GameContinues)
+    {
+        // what the board showed at the end doesn't matter, all of it is reset
+        m_revealedCounts[board] = 0;
+        ++m_games[board];
+        startGame(board);
+        return;
+    }
+
+    const size_t first = static_cast<size_t>(board)*cells;
+    int revealedCount = 0;
+    for (int changed : field.changedCells()) {
+        const KMinesState::CellState state = field.state(changed);
+        const bool revealed = state == KMinesState::Revealed || state == KMinesState::Error;
+        revealedCount += revealed && !m_revealed[first + changed];
+        m_revealed[first + changed] = revealed;
+        m_digits[first + changed] = revealed ? static_cast<std::uint8_t>(field.digit(changed)) : 0;
+        m_flags[first + changed] = state == KMinesState::Flagged;
+    }
+    field.clearChanges();
+    m_revealedCounts[board] = revealedCount;
+}
+
+void BatchEnvironment::startGame(int board)
+{
+    // same size, so this only resets the cells played
+    m_fields[board].init(m_numRows, m_numCols, m_numMines);
+    m_fields[board].clearChanges();
+    const size_t first = static_cast<size_t>(board)*cellCount();
+    std::fill_n(m_revealed.begin() + first, cellCount(), 0);
+    std::fill_n(m_digits.begin() + first, cellCount(), 0);
+    std::fill_n(m_flags.begin() + first, cellCount(), 0);
+}
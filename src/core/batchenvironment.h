@@ -0,0 +1,109 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef BATCHENVIRONMENT_H
+#define BATCHENVIRONMENT_H
+
+// own
+#include "minefield.h"
+// Std
+#include <cstdint>
+#include <vector>
+
+class WorkStealingPool;
+
+/**
+ * Plays many independent boards of the same size at once, for bots.
+ *
+ * Every step() applies one action to each board. What a player sees of the
+ * boards is kept in observation planes, one byte per cell of every board,
+ * board after board (structure of arrays): revealed(), digits() and flags().
+ * step() only rewrites the cells changed by the actions. Boards keep their
+ * fields from game to game, so it allocates nothing once they are warmed up.
+ *
+ * A board whose game ends is reset right away, its planes then show the new
+ * game and outcomes() tells how the previous one ended. Like in the game,
+ * mines are placed on the first reveal of a game, so it is always safe.
+ * Game n of board b is generated from CounterRandom(CounterRandom(seed).at(b)).at(n),
+ * so runs can be reproduced.
+ */
+class BatchEnvironment
+{
+public:
+    /**
+     * Actions are encoded as type*cellCount() + cell index
+     */
+    enum ActionType { Reveal, ToggleFlag, Chord, ACTION_TYPE_COUNT };
+    /**
+     * Outcome of a board given an action out of [0, actionCount()),
+     * after those of MineField::GameResult
+     */
+    static const std::uint8_t INVALID_ACTION = 3;
+
+    BatchEnvironment(int numBoards, int numRows, int numCols, int numMines, std::uint64_t seed);
+    /**
+     * Starts new games on all boards, from game 0 of each board
+     */
+    void reset();
+    /**
+     * Applies actions[b] to board b, for every board. Actions on revealed
+     * cells, flagging revealed cells or chording unsatisfied digits change
+     * nothing. Actions out of range change nothing either, the outcome of
+     * their board is INVALID_ACTION. Boards are split between the threads
+     * of pool, if given
+     */
+    void step(const int* actions, WorkStealingPool* pool = nullptr);
+
+    int boardCount() const { return m_numBoards; }
+    int rowCount() const { return m_numRows; }
+    int columnCount() const { return m_numCols; }
+    int cellCount() const { return m_numRows*m_numCols; }
+    int actionCount() const { return ACTION_TYPE_COUNT*cellCount(); }
+
+    /**
+     * 1 for revealed cells, cell idx of board b is at b*cellCount() + idx
+     */
+    const std::uint8_t* revealed() const { return m_revealed.data(); }
+    /**
+     * Number of mines around revealed cells, 0 for the other ones
+     */
+    const std::uint8_t* digits() const { return m_digits.data(); }
+    /**
+     * 1 for flagged cells
+     */
+    const std::uint8_t* flags() const { return m_flags.data(); }
+    /**
+     * How the game of each board went in the last step, a MineField::GameResult
+     * or INVALID_ACTION: a board with a won or lost game was reset since
+     */
+    const std::uint8_t* outcomes() const { return m_outcomes.data(); }
+    /**
+     * Number of cells revealed on each board by the last step
+     */
+    const int* revealedCounts() const { return m_revealedCounts.data(); }
+
+private:
+    void stepBoard(int board, int action);
+    void startGame(int board);
+
+    int m_numBoards;
+    int m_numRows;
+    int m_numCols;
+    int m_numMines;
+    std::uint64_t m_seed;
+    std::vector<MineField> m_fields;
+    /**
+     * Number of the current game of each board
+     */
+    std::vector<std::uint64_t> m_games;
+    std::vector<std::uint8_t> m_revealed;
+    std::vector<std::uint8_t> m_digits;
+    std::vector<std::uint8_t> m_flags;
+    std::vector<std::uint8_t> m_outcomes;
+    std::vector<int> m_revealedCounts;
+};
+
+#endif
@@ -0,0 +1,163 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "boardqueue.h"
+
+// own
+#include "minefield.h"
+#include "noguessgenerator.h"
+// Std
+#include <algorithm>
+
+BoardQueue::BoardQueue(std::uint64_t seed)
+    : m_random(seed)
+{
+    m_thread = std::thread([this]() { run(); });
+}
+
+BoardQueue::~BoardQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_cancelled = true;
+    }
+    m_wakeUp.notify_one();
+    m_thread.join();
+}
+
+void BoardQueue::setFieldSize(int numRows, int numCols, int numMines)
+{
+    // as MineField::init() does
+    numMines = std::min(numMines, numRows*numCols - MineField::MINIMAL_FREE);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (numRows == m_numRows && numCols == m_numCols && numMines == m_numMines)
+            return;
+        drop();
+        m_numRows = numRows;
+        m_numCols = numCols;
+        m_numMines = numMines;
+    }
+    m_wakeUp.notify_one();
+}
+
+void BoardQueue::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    drop();
+    m_numRows = 0;
+    m_numCols = 0;
+    m_numMines = 0;
+}
+
+void BoardQueue::drop()
+{
+    m_boards.clear();
+    m_cancelled = true;
+    m_failed = false;
+    ++m_generation;
+}
+
+bool BoardQueue::take(MineField& field, int clickedIdx)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (field.rowCount() != m_numRows || field.columnCount() != m_numCols || field.minesCount() != m_numMines)
+            return false;
+
+        const int row = field.rowOf(clickedIdx);
+        const int col = field.colOf(clickedIdx);
+        auto found = m_boards.end();
+        int flips = 0;
+        for (auto board = m_boards.begin(); board != m_boards.end() && found == m_boards.end(); ++board) {
+            // bit 0: mirrored horizontally, bit 1: vertically
+            for (flips = 0; flips < 4; ++flips)
+            {
+                // where the click is in the prepared field
+                const int idx = field.index((flips & 2) ? m_numRows - 1 - row : row,
+                                            (flips & 1) ? m_numCols - 1 - col : col);
+                if (std::binary_search(board->opening.begin(), board->opening.end(), idx))
+                {
+                    found = board;
+                    break;
+                }
+            }
+        }
+        if (found == m_boards.end())
+            return false;
+
+        field.generate(found->startIdx, found->seed);
+        field.flip((flips & 1) != 0, (flips & 2) != 0);
+        m_boards.erase(found);
+    }
+    m_wakeUp.notify_one();
+    return true;
+}
+
+int BoardQueue::readyCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<int>(m_boards.size());
+}
+
+void BoardQueue::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_wakeUp.wait(lock, [this]() {
+            return m_stopping || (m_numRows > 0 && !m_failed && static_cast<int>(m_boards.size()) < CAPACITY);
+        });
+        if (m_stopping)
+            return;
+
+        const int generation = m_generation;
+        const int numRows = m_numRows;
+        const int numCols = m_numCols;
+        const int numMines = m_numMines;
+        const std::uint64_t seed = m_random.next();
+        Board board;
+        board.startIdx = static_cast<int>(m_random.bounded(numRows*numCols));
+        m_cancelled = false;
+
+        lock.unlock();
+        const bool found = prepare(numRows, numCols, numMines, seed, &board);
+        lock.lock();
+
+        // the size changed meanwhile
+        if (generation != m_generation)
+            continue;
+        if (found)
+            m_boards.push_back(std::move(board));
+        else
+            m_failed = true;
+    }
+}
+
+bool BoardQueue::prepare(int numRows, int numCols, int numMines, std::uint64_t seed, Board* board)
+{
+    // half of the cores, the game and its probabilities go on meanwhile
+    const int numThreads = std::max(1u, std::thread::hardware_concurrency() / 2);
+    const int found = NoGuessGenerator::search(numRows, numCols, numMines, board->startIdx, seed,
+                                               numThreads, &m_cancelled);
+    if (found < 0)
+        return false;
+    board->seed = NoGuessGenerator::candidateSeed(seed, found);
+
+    // the cells revealed by the first click are the opening and its digits
+    MineField field;
+    field.init(numRows, numCols, numMines);
+    field.generate(board->startIdx, board->seed);
+    field.reveal(board->startIdx);
+    for (int idx : field.changedCells()) {
+        if (field.digit(idx) == 0)
+            board->opening.push_back(idx);
+    }
+    std::sort(board->opening.begin(), board->opening.end());
+    board->opening.erase(std::unique(board->opening.begin(), board->opening.end()), board->opening.end());
+    return true;
+}
@@ -0,0 +1,125 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef BOARDQUEUE_H
+#define BOARDQUEUE_H
+
+// own
+#include "counterrandom.h"
+// Std
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class MineField;
+
+/**
+ * Prepares fields solvable without guessing in a background thread,
+ * while the current game is played.
+ *
+ * NoGuessGenerator needs the first clicked cell, which is not known ahead.
+ * So every field is searched from a random start cell, and the empty cells
+ * opening the same area as the start cell are remembered: clicking any of
+ * them, in the field or in a mirrored copy of it, gives the same solvable
+ * position. take() uses a prepared field if the click falls in one of these
+ * openings, otherwise the caller generates a field as usual.
+ *
+ * Fields are only prepared for the last given size. Changing it cancels
+ * the running search and drops the prepared fields.
+ */
+class BoardQueue
+{
+public:
+    /**
+     * Number of fields kept ready
+     */
+    static const int CAPACITY = 8;
+
+    /**
+     * @param seed seed for start cells and searches
+     */
+    explicit BoardQueue(std::uint64_t seed);
+    ~BoardQueue();
+    BoardQueue(const BoardQueue&) = delete;
+    BoardQueue& operator=(const BoardQueue&) = delete;
+
+    /**
+     * Starts preparing fields of this size, if it differs from the current one
+     */
+    void setFieldSize(int numRows, int numCols, int numMines);
+    /**
+     * Stops preparing fields and drops the prepared ones
+     */
+    void clear();
+    /**
+     * Generates mines of field, which must be initialized and not played yet,
+     * from a prepared field solvable from clickedIdx. That field is removed
+     * from the queue and the background thread prepares another one.
+     *
+     * @return whether such a field was ready
+     */
+    bool take(MineField& field, int clickedIdx);
+    /**
+     * @return number of fields ready for the current size
+     */
+    int readyCount() const;
+
+private:
+    struct Board
+    {
+        int startIdx = 0;
+        std::uint64_t seed = 0;
+        /**
+         * Sorted indexes of the empty cells of the start opening
+         */
+        std::vector<int> opening;
+    };
+
+    /**
+     * Body of the background thread
+     */
+    void run();
+    /**
+     * Searches a field solvable from board->startIdx
+     *
+     * @return false if none was found or the search was cancelled
+     */
+    bool prepare(int numRows, int numCols, int numMines, std::uint64_t seed, Board* board);
+    /**
+     * Drops prepared fields and cancels the running search, under m_mutex
+     */
+    void drop();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    std::vector<Board> m_boards;
+    /**
+     * Set to stop the running search
+     */
+    std::atomic<bool> m_cancelled{false};
+    /**
+     * Size of prepared fields, 0 rows when none are wanted
+     */
+    int m_numRows = 0;
+    int m_numCols = 0;
+    int m_numMines = 0;
+    /**
+     * Incremented when fields are dropped, so that a search started before is discarded
+     */
+    int m_generation = 0;
+    /**
+     * Whether a search gave up for this size, it is not retried until the size changes
+     */
+    bool m_failed = false;
+    bool m_stopping = false;
+    CounterRandom m_random;
+    std::thread m_thread;
+};
+
+#endif
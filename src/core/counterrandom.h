@@ -0,0 +1,65 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef COUNTERRANDOM_H
+#define COUNTERRANDOM_H
+
+// Std
+#include <cstdint>
+
+/**
+ * Counter-based pseudo random generator.
+ *
+ * The n-th number drawn is the SplitMix64 finalizer applied to the seed plus
+ * n times the golden ratio, as SplitMix64 does. So the sequence only depends
+ * on the seed, the same on every platform and standard library, any position
+ * can be jumped to at no cost, and generators share no state: fields can be
+ * generated on any number of threads and still be reproduced from their seed.
+ */
+class CounterRandom
+{
+public:
+    explicit CounterRandom(std::uint64_t seed, std::uint64_t position = 0)
+        : m_seed(seed), m_position(position)
+    {
+    }
+    /**
+     * @return the number at the current position, moving to the next one
+     */
+    std::uint64_t next() { return at(m_position++); }
+    /**
+     * @return the number at position, without moving
+     */
+    std::uint64_t at(std::uint64_t position) const
+    {
+        std::uint64_t z = m_seed + (position + 1)*0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    std::uint64_t position() const { return m_position; }
+    void seek(std::uint64_t position) { m_position = position; }
+    /**
+     * @return a uniformly distributed number in [0, bound), bound must not be 0.
+     * Multiply and shift, drawing again in the rare biased cases
+     */
+    std::uint32_t bounded(std::uint32_t bound)
+    {
+        const std::uint32_t threshold = static_cast<std::uint32_t>(-bound) % bound;
+        while (true)
+        {
+            const std::uint64_t product = (next() >> 32)*bound;
+            if (static_cast<std::uint32_t>(product) >= threshold)
+                return static_cast<std::uint32_t>(product >> 32);
+        }
+    }
+
+private:
+    std::uint64_t m_seed;
+    std::uint64_t m_position;
+};
+
+#endif
@@ -0,0 +1,187 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "minebitboard.h"
+
+// Std
+#include <array>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KMINES_VECTOR_WORDS 1
+#define KMINES_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define KMINES_ALWAYS_INLINE inline
+#endif
+
+namespace
+{
+
+/**
+ * Vector width in words of the widest kernel, rows are padded to it
+ */
+const int MaxVectorWords = 4;
+
+#ifdef KMINES_VECTOR_WORDS
+// GCC/Clang vector extensions: lowered to SSE2 and AVX2 instructions
+typedef std::uint64_t Sse2Words __attribute__((vector_size(16)));
+typedef std::uint64_t Avx2Words __attribute__((vector_size(32)));
+#endif
+
+// vectors are passed by reference only, so no vector type crosses a call ABI
+
+/**
+ * Loads words at p and their west (bit c gets bit c-1) and east
+ * (bit c gets bit c+1) shifted copies
+ */
+template<typename V>
+KMINES_ALWAYS_INLINE void loadShifted(const std::uint64_t* p, V& west, V& self, V& east)
+{
+    V before;
+    V after;
+    std::memcpy(&before, p - 1, sizeof(V));
+    std::memcpy(&self, p, sizeof(V));
+    std::memcpy(&after, p + 1, sizeof(V));
+    west = (self << 1) | (before >> 63);
+    east = (self >> 1) | (after << 63);
+}
+
+template<typename V>
+KMINES_ALWAYS_INLINE void storeWords(std::uint64_t* p, const V& v)
+{
+    std::memcpy(p, &v, sizeof(V));
+}
+
+/**
+ * Sums the 8 neighbours of every cell of rows [0, numRows) of the board.
+ * V is either a single word or a vector of words.
+ */
+template<typename V>
+KMINES_ALWAYS_INLINE void countRows(const std::uint64_t* mines, int stride, int numRows, int words,
+                                    std::uint64_t* const* counts)
+{
+    const int step = sizeof(V) / sizeof(std::uint64_t);
+    for (int row = 0; row < numRows; ++row)
+    {
+        // data of row r is at mines + (r+1)*stride + 1
+        const std::uint64_t* up = mines + row*stride + 1;
+        const std::uint64_t* cur = up + stride;
+        const std::uint64_t* down = cur + stride;
+        const int outRow = row*words;
+        for (int w = 0; w < words; w += step)
+        {
+            V uw, u, ue, cw, c, ce, dw, d, de;
+            loadShifted(up + w, uw, u, ue);
+            loadShifted(cur + w, cw, c, ce);
+            loadShifted(down + w, dw, d, de);
+
+            // per-row partial sums: 2 bit values (carry, sum)
+            const V s1 = uw ^ u ^ ue;
+            const V c1 = (uw & u) | (ue & (uw ^ u));
+            const V s2 = cw ^ ce;
+            const V c2 = cw & ce;
+            const V s3 = dw ^ d ^ de;
+            const V c3 = (dw & d) | (de & (dw ^ d));
+
+            // add the units, then the twos with the carry from units
+            const V bit0 = s1 ^ s2 ^ s3;
+            const V k = (s1 & s2) | (s3 & (s1 ^ s2));
+            const V twos = c1 ^ c2 ^ c3;
+            const V fours = (c1 & c2) | (c3 & (c1 ^ c2));
+            const V bit1 = twos ^ k;
+            const V carry = twos & k;
+            const V bit2 = fours ^ carry;
+            const V bit3 = fours & carry;
+
+            storeWords(counts[0] + outRow + w, bit0);
+            storeWords(counts[1] + outRow + w, bit1);
+            storeWords(counts[2] + outRow + w, bit2);
+            storeWords(counts[3] + outRow + w, bit3);
+        }
+    }
+}
+
+#ifdef KMINES_VECTOR_WORDS
+__attribute__((target("avx2")))
+void countRowsAvx2(const std::uint64_t* mines, int stride, int numRows, int words, std::uint64_t* const* counts)
+{
+    countRows<Avx2Words>(mines, stride, numRows, words, counts);
+}
+
+void countRowsSse2(const std::uint64_t* mines, int stride, int numRows, int words, std::uint64_t* const* counts)
+{
+    countRows<Sse2Words>(mines, stride, numRows, words, counts);
+}
+#endif
+
+/**
+ * Byte j of spreadBits()[b] is bit j of b
+ */
+const std::array<std::uint64_t, 256>& spreadBits()
+{
+    static const std::array<std::uint64_t, 256> table = [] {
+        std::array<std::uint64_t, 256> t{};
+        for (int b = 0; b < 256; ++b)
+            for (int j = 0; j < 8; ++j)
+                if (b & (1 << j))
+                    t[b] |= std::uint64_t(1) << (8*j);
+        return t;
+    }();
+    return table;
+}
+
+}
+
+void MineBitBoard::reset(int numRows, int numCols)
+{
+    m_numRows = numRows;
+    m_numCols = numCols;
+    m_words = ((numCols + 63) / 64 + MaxVectorWords - 1) / MaxVectorWords * MaxVectorWords;
+    m_minesStride = m_words + 2;
+    m_mines.assign((numRows + 2)*m_minesStride, 0);
+    for (std::vector<std::uint64_t>& plane : m_counts)
+        plane.resize(numRows*m_words);
+}
+
+void MineBitBoard::countNeighbours()
+{
+    std::uint64_t* const counts[4] = { m_counts[0].data(), m_counts[1].data(), m_counts[2].data(), m_counts[3].data() };
+#ifdef KMINES_VECTOR_WORDS
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2)
+        countRowsAvx2(m_mines.data(), m_minesStride, m_numRows, m_words, counts);
+    else
+        countRowsSse2(m_mines.data(), m_minesStride, m_numRows, m_words, counts);
+#else
+    countRows<std::uint64_t>(m_mines.data(), m_minesStride, m_numRows, m_words, counts);
+#endif
+}
+
+void MineBitBoard::writeCells(int row, std::uint8_t* dst, std::uint8_t mineBit) const
+{
+    const std::array<std::uint64_t, 256>& spread = spreadBits();
+    const std::uint64_t* mines = minesRow(row) + 1;
+    const std::uint64_t* counts[4];
+    for (int b = 0; b < 4; ++b)
+        counts[b] = m_counts[b].data() + row*m_words;
+
+    // 8 cells per step: every byte of a plane spreads into one bit of 8 cell bytes
+    for (int col = 0; col < m_numCols; col += 8)
+    {
+        const int word = col / 64;
+        const int shift = col % 64;
+        const std::uint64_t mine8 = spread[(mines[word] >> shift) & 0xff];
+        std::uint64_t cells = 0;
+        for (int b = 0; b < 4; ++b)
+            cells |= spread[(counts[b][word] >> shift) & 0xff] << b;
+        // mined cells keep count 0
+        cells = (cells & ~(mine8 * 0x0f)) | mine8 * mineBit;
+
+        const int n = m_numCols - col < 8 ? m_numCols - col : 8;
+        for (int j = 0; j < n; ++j)
+            dst[col + j] = static_cast<std::uint8_t>(cells >> (8*j));
+    }
+}
@@ -0,0 +1,66 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef MINEBITBOARD_H
+#define MINEBITBOARD_H
+
+// Std
+#include <cstdint>
+#include <vector>
+
+/**
+ * Mine positions packed one bit per cell, 64 cells per word.
+ *
+ * countNeighbours() computes the number of mines around every cell at once:
+ * the 8 shifted copies of the board are summed with bitwise full adders into
+ * 4 bit planes, processing whole words (or SSE2/AVX2 vectors of words) at a
+ * time. writeCells() then unpacks the result into MineField cell bytes.
+ */
+class MineBitBoard
+{
+public:
+    /**
+     * Resizes the board and removes all mines
+     */
+    void reset(int numRows, int numCols);
+    void setMine(int row, int col)
+    {
+        minesRow(row)[1 + col / 64] |= std::uint64_t(1) << (col % 64);
+    }
+    /**
+     * Computes the neighbour counts of all cells
+     */
+    void countNeighbours();
+    /**
+     * Writes one row of cells to dst: neighbour count in the low bits
+     * and mineBit for mined cells (whose count is left 0)
+     */
+    void writeCells(int row, std::uint8_t* dst, std::uint8_t mineBit) const;
+
+private:
+    /**
+     * Mines of a row. Rows have a zero word before and after the data
+     * and there is a zero row above and below the board, so shifted reads
+     * never need special cases
+     */
+    std::uint64_t* minesRow(int row) { return &m_mines[(row + 1)*m_minesStride]; }
+    const std::uint64_t* minesRow(int row) const { return &m_mines[(row + 1)*m_minesStride]; }
+
+    int m_numRows = 0;
+    int m_numCols = 0;
+    /**
+     * Data words per row, rounded up to the widest vector size
+     */
+    int m_words = 0;
+    int m_minesStride = 0;
+    std::vector<std::uint64_t> m_mines;
+    /**
+     * Bit planes of the neighbour counts: plane b holds bit b of every count
+     */
+    std::vector<std::uint64_t> m_counts[4];
+};
+
+#endif
@@ -0,0 +1,575 @@
+/*
+    SPDX-FileCopyrightText: 2007 Dmitry Suzdalev <dimsuz@gmail.com>
+    SPDX-FileCopyrightText: 2010 Brian Croom <brian.s.croom@gmail.com>
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "minefield.h"
+
+// own
+#include "counterrandom.h"
+// Std
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <limits>
+
+constexpr std::array<std::array<int, 2>, 8> MineField::s_neighbourDeltas;
+
+MineField::MineField()
+{
+}
+
+void MineField::init(int numRows, int numCols, int numMines)
+{
+    const bool sameSize = numRows == m_numRows && numCols == m_numCols && !m_content.empty();
+    const bool mostlyPlayed = m_touched.size() > static_cast<size_t>(numRows*numCols / 4);
+    m_numRows = numRows;
+    m_numCols = numCols;
+    m_stride = numCols + 2;
+    m_minesCount = std::min(numMines, numRows*numCols - MINIMAL_FREE);
+    m_generated = false;
+    m_origin = Origin();
+
+    // same size: the layout is still valid, only played cells need a reset,
+    // unless most cells were played: filling whole arrays is quicker then.
+    // Mines and digits are overwritten by generate()
+    if (sameSize && !mostlyPlayed)
+    {
+        reset();
+        m_changed.clear();
+        return;
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        m_neighbourOffsets[i] = s_neighbourDeltas[i][0]*m_stride + s_neighbourDeltas[i][1];
+        m_indexOffsets[i] = s_neighbourDeltas[i][0]*m_numCols + s_neighbourDeltas[i][1];
+    }
+
+    // let it be empty by default
+    // generate() will adjust needed cells
+    // to hold digits or mines.
+    // Sentinels around the field look like revealed empty cells,
+    // so neighbour walks never step on them
+    const int paddedSize = (numRows + 2)*m_stride;
+    m_content.assign(paddedSize, BorderBit);
+    m_state.assign(paddedSize, KMinesState::Revealed);
+    // positions of sentinels depend on the shape, not only on the size
+    m_openingOf.assign(paddedSize, -1);
+    forEachCell([this](int pos) {
+        m_content[pos] = 0;
+        m_state[pos] = KMinesState::Released;
+    });
+    m_changed.clear();
+    m_touched.clear();
+    reset();
+}
+
+void MineField::reset()
+{
+    m_gameOver = false;
+    m_numUnrevealed = cellCount();
+    m_flaggedMinesCount = 0;
+
+    // when most cells were touched, walking them in memory order is quicker
+    if (m_touched.size() > static_cast<size_t>(cellCount() / 4))
+    {
+        for (int row = 0; row < m_numRows; ++row)
+        {
+            const int first = (row + 1)*m_stride + 1;
+            for (int col = 0; col < m_numCols; ++col)
+            {
+                const int pos = first + col;
+                m_content[pos] &= ~ExplodedBit;
+                if (m_state[pos] != KMinesState::Released)
+                {
+                    m_state[pos] = KMinesState::Released;
+                    m_changed.push_back(index(row, col));
+                }
+            }
+        }
+        if (m_generated)
+            m_openingBlocked.assign(m_openingBlocked.size(), 0);
+        m_touched.clear();
+        return;
+    }
+
+    // explosions only happen on revealed, so touched, cells
+    for (int pos : m_touched) {
+        m_content[pos] &= ~ExplodedBit;
+        if (m_state[pos] != KMinesState::Released)
+        {
+            updateOpeningBlocked(pos, -1);
+            m_state[pos] = KMinesState::Released;
+            m_changed.push_back(toIndex(pos));
+        }
+    }
+    m_touched.clear();
+}
+
+void MineField::generate(int clickedIdx, std::uint64_t seed)
+{
+    // generating mines ensuring that clickedIdx won't hold mine
+    // and that it will be an empty cell so the user don't have
+    // to make random guesses at the start of the game.
+    // So candidates are all cells except the clicked one and its neighbours
+    const int clickedRow = rowOf(clickedIdx);
+    const int clickedCol = colOf(clickedIdx);
+    m_bitBoard.reset(m_numRows, m_numCols);
+    m_candidates.clear();
+    for (int row = 0; row < m_numRows; ++row)
+    {
+        const int first = (row + 1)*m_stride + 1;
+        for (int col = 0; col < m_numCols; ++col)
+        {
+            if (std::abs(row - clickedRow) > 1 || std::abs(col - clickedCol) > 1)
+                m_candidates.push_back(first + col);
+        }
+    }
+    assert(static_cast<int>(m_candidates.size()) >= m_minesCount);
+
+    // partial Fisher-Yates shuffle: after step i the first i+1 candidates
+    // are a uniformly chosen set of mined cells, whatever the density is.
+    // Candidates are in index order and drawn numbers don't depend on the
+    // platform, so the field only depends on seed, size, mines and clickedIdx
+    CounterRandom random(seed);
+    const int numCandidates = static_cast<int>(m_candidates.size());
+    for (int i = 0; i < m_minesCount; ++i)
+    {
+        std::swap(m_candidates[i], m_candidates[i + static_cast<int>(random.bounded(numCandidates - i))]);
+        // ok, let's mine this place! :-)
+        const int pos = m_candidates[i];
+        m_bitBoard.setMine(pos / m_stride - 1, pos % m_stride - 1);
+    }
+
+    // digits of all cells are computed in one pass over the packed board
+    m_bitBoard.countNeighbours();
+    for (int row = 0; row < m_numRows; ++row)
+        m_bitBoard.writeCells(row, &m_content[(row + 1)*m_stride + 1], MineBit);
+    labelOpenings();
+    m_origin = Origin();
+    m_origin.seed = seed;
+    m_origin.clickedIdx = clickedIdx;
+    m_generated = true;
+}
+
+void MineField::labelOpenings()
+{
+    // union-find on m_openingOf, joining every empty cell with the empty
+    // cells among its neighbours visited before it. Roots are linked to the
+    // lower root, so a parent is always at a lower position than its child.
+    // Sentinels, mines and digits are all not 0
+    const std::uint8_t* const content = m_content.data();
+    // sentinels are never written below, they stay -1 from init()
+    int* const parent = m_openingOf.data();
+    const auto find = [parent](int pos) {
+        while (parent[pos] != pos)
+        {
+            parent[pos] = parent[parent[pos]];
+            pos = parent[pos];
+        }
+        return pos;
+    };
+    forEachCell([&](int pos) {
+        if (content[pos] != 0)
+        {
+            parent[pos] = -1;
+            return;
+        }
+        // neighbouring empty cells are joined already: if the one above
+        // is empty, it is joined with the other ones visited before,
+        // otherwise the left and upper left ones are joined together
+        const int up = pos - m_stride;
+        if (content[up] == 0)
+        {
+            parent[pos] = up;
+            return;
+        }
+        if (content[pos - 1] == 0)
+            parent[pos] = pos - 1;
+        else if (content[up - 1] == 0)
+            parent[pos] = up - 1;
+        else
+            parent[pos] = pos;
+        if (content[up + 1] == 0)
+        {
+            const int a = find(pos);
+            const int b = find(up + 1);
+            if (a != b)
+                parent[std::max(a, b)] = std::min(a, b);
+        }
+    });
+
+    // label in position order, in place: a parent has its label already,
+    // and it is the label of its whole set. Empty cells are counted along
+    m_openingStart.assign(1, 0);
+    forEachCell([&](int pos) {
+        if (parent[pos] < 0)
+            return;
+        if (parent[pos] == pos)
+        {
+            m_openingOf[pos] = static_cast<int>(m_openingStart.size()) - 1;
+            m_openingStart.push_back(1);
+        }
+        else
+        {
+            m_openingOf[pos] = m_openingOf[parent[pos]];
+            ++m_openingStart[m_openingOf[pos] + 1];
+        }
+    });
+    const int numOpenings = openingCount();
+
+    // stores labels of the openings around the digit at pos, returns their number.
+    // Mostly there are none or one, which is found without branching on each neighbour
+    const auto openingsAround = [this](int pos, int* labels) {
+        int highest = -1;
+        int lowest = std::numeric_limits<int>::max();
+        for (int offset : m_neighbourOffsets) {
+            const int label = m_openingOf[pos + offset];
+            highest = std::max(highest, label);
+            lowest = std::min(lowest, label < 0 ? std::numeric_limits<int>::max() : label);
+        }
+        if (highest < 0)
+            return 0;
+        labels[0] = lowest;
+        if (lowest == highest)
+            return 1;
+        int numLabels = 1;
+        for (int offset : m_neighbourOffsets) {
+            const int label = m_openingOf[pos + offset];
+            if (label >= 0 && std::find(labels, labels + numLabels, label) == labels + numLabels)
+                labels[numLabels++] = label;
+        }
+        return numLabels;
+    };
+
+    // digits around openings, the others need a click each. The ones around
+    // openings are remembered with their labels, as pos, count, labels...
+    int labels[8];
+    m_bbbv = numOpenings;
+    std::vector<int>& bordering = m_fillBatch;
+    bordering.clear();
+    forEachCell([&](int pos) {
+        if (content[pos] == 0 || (content[pos] & MineBit))
+            return;
+        const int numLabels = openingsAround(pos, labels);
+        if (numLabels == 0)
+        {
+            ++m_bbbv;
+            return;
+        }
+        bordering.push_back(pos);
+        bordering.push_back(numLabels);
+        for (int i = 0; i < numLabels; ++i) {
+            bordering.push_back(labels[i]);
+            ++m_openingStart[labels[i] + 1];
+        }
+    });
+    for (int i = 0; i < numOpenings; ++i)
+        m_openingStart[i + 1] += m_openingStart[i];
+
+    // then the cells are listed in position order
+    m_openingCells.resize(m_openingStart[numOpenings]);
+    m_openingBlocked.assign(m_openingStart.begin(), m_openingStart.end() - 1);
+    std::vector<int>& next = m_openingBlocked;
+    size_t digit = 0;
+    forEachCell([&](int pos) {
+        if (content[pos] == 0)
+            m_openingCells[next[m_openingOf[pos]]++] = pos;
+        else if (digit < bordering.size() && bordering[digit] == pos)
+        {
+            const int numLabels = bordering[digit + 1];
+            for (int i = 0; i < numLabels; ++i)
+                m_openingCells[next[bordering[digit + 2 + i]]++] = pos;
+            digit += 2 + numLabels;
+        }
+    });
+    m_openingBlocked.assign(numOpenings, 0);
+    // only marks may be there, on touched cells, which may be listed twice
+    m_fillStack.assign(m_touched.begin(), m_touched.end());
+    std::sort(m_fillStack.begin(), m_fillStack.end());
+    m_fillStack.erase(std::unique(m_fillStack.begin(), m_fillStack.end()), m_fillStack.end());
+    for (int pos : m_fillStack) {
+        if (m_openingOf[pos] >= 0 && cellState(pos) != KMinesState::Released)
+            ++m_openingBlocked[m_openingOf[pos]];
+    }
+}
+
+void MineField::flip(bool horizontally, bool vertically)
+{
+    // only mines and digits move, marks placed before the first reveal stay
+    // on their cells. The neighbours of a cell are mirrored with it,
+    // so its digit stays valid
+    if (horizontally)
+    {
+        for (int row = 0; row < m_numRows; ++row)
+        {
+            const auto first = m_content.begin() + (row + 1)*m_stride + 1;
+            std::reverse(first, first + m_numCols);
+        }
+    }
+    if (vertically)
+    {
+        for (int row = 0; row < m_numRows / 2; ++row)
+        {
+            const auto first = m_content.begin() + (row + 1)*m_stride + 1;
+            const auto mirrored = m_content.begin() + (m_numRows - row)*m_stride + 1;
+            std::swap_ranges(first, first + m_numCols, mirrored);
+        }
+    }
+    labelOpenings();
+    m_origin.flippedHorizontally ^= horizontally;
+    m_origin.flippedVertically ^= vertically;
+}
+
+MineField::Neighbours MineField::neighbours(int idx) const
+{
+    Neighbours result;
+    const int pos = toPadded(idx);
+    for (int i = 0; i < 8; ++i) {
+        if (!(m_content[pos + m_neighbourOffsets[i]] & BorderBit))
+            result.cells[result.count++] = idx + m_indexOffsets[i];
+    }
+    return result;
+}
+
+void MineField::revealCell(int pos)
+{
+    if (isRevealedAt(pos))
+        return; // already revealed
+
+    if (cellState(pos) == KMinesState::Flagged && !(m_content[pos] & MineBit))
+        setState(pos, KMinesState::Error);
+    else
+        setState(pos, KMinesState::Revealed);
+}
+
+MineField::GameResult MineField::reveal(int idx)
+{
+    const int pos = toPadded(idx);
+    if (m_gameOver || cellState(pos) != KMinesState::Released)
+        return GameContinues;
+
+    // if we hold mine, let's explode
+    if (m_content[pos] & MineBit)
+        m_content[pos] |= ExplodedBit;
+    revealCell(pos);
+    return onCellRevealed(pos);
+}
+
+MineField::GameResult MineField::chord(int idx)
+{
+    const int pos = toPadded(idx);
+    if (m_gameOver || !isRevealedAt(pos))
+        return GameContinues;
+
+    int numFlags = 0;
+    int numMines = 0;
+    forEachNeighbour(pos, [&](int n) {
+        numFlags += cellState(n) == KMinesState::Flagged;
+        numMines += (m_content[n] & MineBit) != 0;
+    });
+    if (numFlags != numMines || numFlags == 0)
+        return GameContinues;
+
+    GameResult result = GameContinues;
+    forEachNeighbour(pos, [&](int n) {
+        // revealing only unrevealed and unmarked ones.
+        // If revealing a cell ends the game, stop there
+        if (result == GameContinues && cellState(n) == KMinesState::Released) {
+            if (m_content[n] & MineBit)
+                m_content[n] |= ExplodedBit;
+            revealCell(n);
+            result = onCellRevealed(n);
+        }
+    });
+    return result;
+}
+
+bool MineField::mark(int idx, bool useQuestionMarks)
+{
+    if (m_gameOver)
+        return false;
+
+    const int pos = toPadded(idx);
+    // this will provide cycling through
+    // Released -> "?"-mark -> "RedFlag"-mark -> Released
+    switch (cellState(pos))
+    {
+        case KMinesState::Released:
+            setState(pos, KMinesState::Flagged);
+            updateOpeningBlocked(pos, 1);
+            m_flaggedMinesCount++;
+            return true;
+        case KMinesState::Flagged:
+            setState(pos, useQuestionMarks ? KMinesState::Questioned : KMinesState::Released);
+            if (!useQuestionMarks)
+                updateOpeningBlocked(pos, -1);
+            m_flaggedMinesCount--;
+            return true;
+        case KMinesState::Questioned:
+            setState(pos, KMinesState::Released);
+            updateOpeningBlocked(pos, -1);
+            return false;
+        default:
+            // shouldn't be here
+            return false;
+    }
+}
+
+MineField::GameResult MineField::onCellRevealed(int pos)
+{
+    m_numUnrevealed--;
+    // revealing a mine is the only way to lose, no need to look for explosions
+    if (m_content[pos] & MineBit)
+    {
+        m_gameOver = true;
+        revealAllMines();
+        return GameLost;
+    }
+    if (m_content[pos] == 0) // empty cell
+    {
+        const std::vector<int>& opened = revealOpening(pos);
+        m_numUnrevealed -= static_cast<int>(opened.size());
+        m_touched.insert(m_touched.end(), opened.begin(), opened.end());
+        for (int n : opened)
+            m_changed.push_back(toIndex(n));
+    }
+
+    // now let's check for possible win
+    return checkWon() ? GameWon : GameContinues;
+}
+
+const std::vector<int>& MineField::revealOpening(int pos)
+{
+    const int opening = m_openingOf[pos];
+    if (m_openingBlocked[opening] > 0)
+    {
+        // marks may cut the opening, open what is reachable from pos
+        const std::vector<int>& opened = revealEmptySpace(pos);
+        updateOpeningBlocked(pos, 1);
+        for (int p : opened)
+            updateOpeningBlocked(p, 1);
+        return opened;
+    }
+
+    // pos is already revealed by the caller and digits may be marked
+    m_fillBatch.clear();
+    int numEmpty = 1;
+    for (int i = m_openingStart[opening]; i < m_openingStart[opening + 1]; ++i)
+    {
+        const int p = m_openingCells[i];
+        if (m_state[p] == KMinesState::Released)
+        {
+            m_state[p] = KMinesState::Revealed;
+            m_fillBatch.push_back(p);
+            numEmpty += m_content[p] == 0;
+        }
+    }
+    m_openingBlocked[opening] = numEmpty;
+    return m_fillBatch;
+}
+
+const std::vector<int>& MineField::revealEmptySpace(int pos)
+{
+    // Span fill: every stack entry is an empty cell starting a horizontal
+    // run of empty cells which still has to be opened. Opening a run also
+    // reveals everything touching it and queues the runs found in the rows
+    // above and below.
+    // Revealed, marked and sentinel cells are all not Released, so they stop the fill.
+    std::uint8_t* const state = m_state.data();
+    const std::uint8_t* const content = m_content.data();
+    const auto isReleased = [state](int p) { return state[p] == KMinesState::Released; };
+    const auto open = [this, state](int p) {
+        state[p] = KMinesState::Revealed;
+        m_fillBatch.push_back(p);
+    };
+
+    m_fillBatch.clear();
+    m_fillStack.clear();
+    m_fillStack.push_back(pos);
+    bool first = true; // pos itself is already revealed by the caller
+    while (!m_fillStack.empty())
+    {
+        const int seed = m_fillStack.back();
+        m_fillStack.pop_back();
+        if (!first)
+        {
+            // runs may be queued more than once
+            if (!isReleased(seed))
+                continue;
+            open(seed);
+        }
+        first = false;
+
+        int left = seed;
+        int right = seed;
+        while (isReleased(left - 1) && content[left - 1] == 0)
+            open(--left);
+        while (isReleased(right + 1) && content[right + 1] == 0)
+            open(++right);
+        // cells with digits bounding the run
+        if (isReleased(left - 1))
+            open(left - 1);
+        if (isReleased(right + 1))
+            open(right + 1);
+
+        for (const int rowOffset : { -m_stride, m_stride })
+        {
+            bool inRun = false;
+            for (int p = left - 1 + rowOffset; p <= right + 1 + rowOffset; ++p)
+            {
+                if (!isReleased(p))
+                    inRun = false;
+                else if (content[p] == 0)
+                {
+                    if (!inRun)
+                        m_fillStack.push_back(p);
+                    inRun = true;
+                }
+                else
+                {
+                    open(p);
+                    inRun = false;
+                }
+            }
+        }
+    }
+    return m_fillBatch;
+}
+
+void MineField::revealAllMines()
+{
+    forEachCell([this](int pos) {
+        const bool flagged = cellState(pos) == KMinesState::Flagged;
+        const bool mined = m_content[pos] & MineBit;
+        if (flagged != mined)
+        {
+            revealCell(pos);
+            m_numUnrevealed--;
+        }
+    });
+}
+
+bool MineField::checkWon()
+{
+    // this also takes into account the trivial case when
+    // only some cells left unflagged and they
+    // all contain bombs. this counts as win.
+    // The unrevealed cells counter makes it O(1) until it happens
+    if (m_numUnrevealed == m_minesCount)
+    {
+        // mark not flagged cells (if any) with flags
+        forEachCell([this](int pos) {
+            if (!isRevealedAt(pos) && cellState(pos) != KMinesState::Flagged)
+                setState(pos, KMinesState::Flagged);
+        });
+        m_gameOver = true;
+        // now all mines should be flagged
+        m_flaggedMinesCount = m_minesCount;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,355 @@
+/*
+    SPDX-FileCopyrightText: 2007 Dmitry Suzdalev <dimsuz@gmail.com>
+    SPDX-FileCopyrightText: 2010 Brian Croom <brian.s.croom@gmail.com>
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef MINEFIELD_H
+#define MINEFIELD_H
+
+// own
+#include "commondefs.h"
+#include "minebitboard.h"
+// Std
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Headless minesweeper board model.
+ *
+ * Holds the whole game state in compact byte-per-cell arrays and
+ * implements all game rules (generation, revealing, chording, marking,
+ * win/loss detection). It has no dependency on Qt GUI classes, so it
+ * can be driven by MineFieldItem as well as by simulations and benchmarks.
+ *
+ * Cells are addressed by index (row*columnCount() + col).
+ * Every cell whose state changes is recorded in a change list, which
+ * views use to update only what is needed.
+ *
+ * Internally the board is stored with a one cell wide sentinel border
+ * around it, so walking the 8 neighbours of any cell is a loop over
+ * a fixed offset table, without allocations or boundary checks.
+ *
+ * Openings (connected areas of empty cells, with the digits around them)
+ * are labelled when mines are generated, so revealing an empty cell
+ * opens a precomputed list of cells instead of searching it.
+ */
+class MineField
+{
+public:
+    enum GameResult { GameContinues, GameWon, GameLost };
+
+    /**
+     * Fixed capacity list of neighbour indexes, see neighbours()
+     */
+    struct Neighbours
+    {
+        const int* begin() const { return cells; }
+        const int* end() const { return cells + count; }
+        int cells[8];
+        int count = 0;
+    };
+
+    /**
+     * Minimal number of free positions on a field
+     */
+    static const int MINIMAL_FREE = 10;
+
+    /**
+     * How the current mines were made: generate() from a seed and a
+     * clicked cell, then maybe flip()
+     */
+    struct Origin
+    {
+        std::uint64_t seed = 0;
+        int clickedIdx = -1;
+        bool flippedHorizontally = false;
+        bool flippedVertically = false;
+    };
+
+    MineField();
+    /**
+     * Initializes empty field. Mines are placed later by generate()
+     * and mines or digits must not be queried before.
+     * When the size doesn't change it costs at most as much as reset()
+     *
+     * @param numRows number of rows
+     * @param numCols number of columns
+     * @param numMines number of mines
+     */
+    void init(int numRows, int numCols, int numMines);
+    /**
+     * Resets all cells to the initial (unrevealed) state,
+     * keeping the generated mines in place.
+     * Only cells changed since the last init() or reset() are visited,
+     * so it costs as much as the moves played, not the field size,
+     * and at most one pass over the field.
+     */
+    void reset();
+    /**
+     * Generates game field ensuring that cell at clickedIdx
+     * will be empty to allow the player quickly jump into the game.
+     * The same seed, size, number of mines and clickedIdx always
+     * give the same field, on any platform.
+     *
+     * @param clickedIdx specifies index which should NOT have mine and be empty
+     * @param seed seed for random generator
+     */
+    void generate(int clickedIdx, std::uint64_t seed);
+    /**
+     * Mirrors the generated mines, swapping left and right columns and/or
+     * top and bottom rows. It must be called before any cell is revealed,
+     * marks are left where they are.
+     * Digits are mirrored as well, so the result is a valid field
+     */
+    void flip(bool horizontally, bool vertically);
+    /**
+     * @return whether mines were already placed by generate()
+     */
+    bool isGenerated() const { return m_generated; }
+    /**
+     * @return how the field was generated, valid once generated.
+     * Generating a field of the same size from the seed and clickedIdx,
+     * then flipping it the same way, gives the same mines
+     */
+    const Origin& origin() const { return m_origin; }
+    /**
+     * @return whether the game is finished
+     */
+    bool isGameOver() const { return m_gameOver; }
+
+    int rowCount() const { return m_numRows; }
+    int columnCount() const { return m_numCols; }
+    int cellCount() const { return m_numRows*m_numCols; }
+    int minesCount() const { return m_minesCount; }
+    int flaggedCount() const { return m_flaggedMinesCount; }
+
+    int index(int row, int col) const { return row*m_numCols + col; }
+    int rowOf(int idx) const { return idx / m_numCols; }
+    int colOf(int idx) const { return idx % m_numCols; }
+
+    KMinesState::CellState state(int idx) const { return cellState(toPadded(idx)); }
+    bool hasMine(int idx) const { return m_content[toPadded(idx)] & MineBit; }
+    bool isExploded(int idx) const { return m_content[toPadded(idx)] & ExplodedBit; }
+    /**
+     * @return number of mines around cell, 0 for mines and empty cells
+     */
+    int digit(int idx) const { return m_content[toPadded(idx)] & DigitMask; }
+    bool isRevealed(int idx) const { return isRevealedAt(toPadded(idx)); }
+    bool isFlagged(int idx) const { return cellState(toPadded(idx)) == KMinesState::Flagged; }
+    bool isQuestioned(int idx) const { return cellState(toPadded(idx)) == KMinesState::Questioned; }
+    /**
+     * @return label of the opening holding the empty cell at idx,
+     * -1 for other cells. Labels are numbered from 0 in index order.
+     * This and the functions below are only valid once generated
+     */
+    int openingOf(int idx) const { return m_openingOf[toPadded(idx)]; }
+    /**
+     * @return number of openings, areas of empty cells revealed by a single click
+     */
+    int openingCount() const { return static_cast<int>(m_openingStart.size()) - 1; }
+    /**
+     * @return the 3BV of the field: the minimal number of clicks revealing
+     * all safe cells, one per opening and one per digit not bordering one
+     */
+    int bbbv() const { return m_bbbv; }
+    /**
+     * @return indexes of all cells adjacent to cell at idx
+     */
+    Neighbours neighbours(int idx) const;
+
+    /**
+     * Reveals cell at idx (if it is not marked or revealed yet),
+     * opening empty space around it.
+     */
+    GameResult reveal(int idx);
+    /**
+     * Reveals all unmarked neighbours of the revealed cell at idx,
+     * if the number of flags around it matches the number of mines.
+     */
+    GameResult chord(int idx);
+    /**
+     * Cycles marks on the cell at idx:
+     * Released -> Flagged -> Questioned (if enabled) -> Released
+     *
+     * @return whether the flag count has changed
+     */
+    bool mark(int idx, bool useQuestionMarks);
+
+    /**
+     * Indexes of cells changed since the last clearChanges() call.
+     * May contain duplicates.
+     */
+    const std::vector<int>& changedCells() const { return m_changed; }
+    void clearChanges() { m_changed.clear(); }
+
+private:
+    friend class MineProbability;
+    friend class MineSolver;
+
+    enum ContentBits : std::uint8_t { DigitMask = 0x0f, MineBit = 0x10, ExplodedBit = 0x20, BorderBit = 0x40 };
+
+    /**
+     * (row, col) deltas of the 8 neighbours, in the traditional
+     * top-left to bottom-right order
+     */
+    static constexpr std::array<std::array<int, 2>, 8> s_neighbourDeltas = {{
+        {{-1, -1}}, {{-1, 0}}, {{-1, 1}},
+        {{ 0, -1}},            {{ 0, 1}},
+        {{ 1, -1}}, {{ 1, 0}}, {{ 1, 1}}
+    }};
+
+    // "pos" arguments of the functions below are indexes in padded arrays
+
+    int toPadded(int idx) const { return idx + 2*(idx / m_numCols) + m_stride + 1; }
+    int toIndex(int pos) const { return pos - 2*(pos / m_stride) - m_stride + 1; }
+    KMinesState::CellState cellState(int pos) const { return static_cast<KMinesState::CellState>(m_state[pos]); }
+    bool isRevealedAt(int pos) const
+    {
+        return m_state[pos] == KMinesState::Revealed || m_state[pos] == KMinesState::Error;
+    }
+    void setState(int pos, KMinesState::CellState state)
+    {
+        m_state[pos] = state;
+        m_changed.push_back(toIndex(pos));
+        m_touched.push_back(pos);
+    }
+    /**
+     * Calls f(neighbourPos) for each of the 8 neighbours of pos.
+     * Sentinel border cells are included, they look revealed, empty and unmined
+     */
+    template<typename F>
+    void forEachNeighbour(int pos, F f) const
+    {
+        for (int offset : m_neighbourOffsets)
+            f(pos + offset);
+    }
+    /**
+     * Calls f(pos) for each cell of the field, skipping sentinels
+     */
+    template<typename F>
+    void forEachCell(F f) const
+    {
+        for (int row = 0; row < m_numRows; ++row) {
+            const int first = (row + 1)*m_stride + 1;
+            for (int pos = first; pos < first + m_numCols; ++pos)
+                f(pos);
+        }
+    }
+    /**
+     * Reveals single cell, turning wrong flags into errors
+     */
+    void revealCell(int pos);
+    /**
+     * Handles consequences of revealing a cell: opening, mines reveal, win/loss.
+     * Costs O(cells revealed), except when the game ends
+     */
+    GameResult onCellRevealed(int pos);
+    /**
+     * Reveals the rest of the opening holding the revealed empty cell at pos.
+     * Untouched openings are revealed from their precomputed cells,
+     * the others by revealEmptySpace().
+     *
+     * @return positions of all cells revealed by this call
+     */
+    const std::vector<int>& revealOpening(int pos);
+    /**
+     * Reveals all empty cells around the revealed empty cell at pos,
+     * until it found cells with digits (which are also revealed).
+     * Marked cells stop it.
+     *
+     * @return positions of all cells revealed by this call
+     */
+    const std::vector<int>& revealEmptySpace(int pos);
+    /**
+     * Labels openings of the generated field with a union-find pass
+     * and lists their cells, computing the 3BV along
+     */
+    void labelOpenings();
+    /**
+     * Tells that the state of the empty cell at pos changed between
+     * Released and any other state, by delta
+     */
+    void updateOpeningBlocked(int pos, int delta)
+    {
+        if (m_generated && m_openingOf[pos] >= 0)
+            m_openingBlocked[m_openingOf[pos]] += delta;
+    }
+    /**
+     * Reveals all unmarked cells containing mines and wrongly flagged cells
+     */
+    void revealAllMines();
+    bool checkWon();
+
+    /**
+     * Per-cell digit, mine and explosion bits, in padded layout
+     */
+    std::vector<std::uint8_t> m_content;
+    /**
+     * Per-cell KMinesState::CellState, in padded layout
+     */
+    std::vector<std::uint8_t> m_state;
+    std::vector<int> m_changed;
+    /**
+     * Positions of cells changed since the last init() or reset(),
+     * which are the only ones reset() has to restore. May contain duplicates
+     */
+    std::vector<int> m_touched;
+    /**
+     * Work stack and result of revealEmptySpace(), kept to reuse their memory
+     */
+    std::vector<int> m_fillStack;
+    std::vector<int> m_fillBatch;
+    /**
+     * Opening label of every empty cell, -1 for other cells, in padded layout
+     */
+    std::vector<int> m_openingOf;
+    /**
+     * Cells of each opening, its empty cells and the digits around them:
+     * those of opening n are m_openingCells[m_openingStart[n]] up to
+     * m_openingCells[m_openingStart[n + 1]]. Digits touching several
+     * openings are listed in each of them
+     */
+    std::vector<int> m_openingStart;
+    std::vector<int> m_openingCells;
+    /**
+     * Number of empty cells of each opening which are not Released.
+     * Only an opening without any can be revealed from m_openingCells,
+     * otherwise marks may cut it
+     */
+    std::vector<int> m_openingBlocked;
+    int m_bbbv = 0;
+    /**
+     * Cells which may receive a mine in generate(), kept to reuse its memory
+     */
+    std::vector<int> m_candidates;
+    /**
+     * Packed mines used to compute digits in generate()
+     */
+    MineBitBoard m_bitBoard;
+    /**
+     * Offsets of the 8 neighbours in padded arrays
+     */
+    std::array<int, 8> m_neighbourOffsets = {};
+    /**
+     * Offsets of the 8 neighbours in unpadded (public) indexes
+     */
+    std::array<int, 8> m_indexOffsets = {};
+    int m_numRows = 0;
+    int m_numCols = 0;
+    /**
+     * Row length of padded arrays
+     */
+    int m_stride = 0;
+    int m_minesCount = 0;
+    int m_flaggedMinesCount = 0;
+    int m_numUnrevealed = 0;
+    Origin m_origin;
+    bool m_generated = false;
+    bool m_gameOver = false;
+};
+
+#endif
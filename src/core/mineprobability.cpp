@@ -0,0 +1,448 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "mineprobability.h"
+
+// own
+#include "minefield.h"
+#include "minesolver.h"
+// Std
+#include <algorithm>
+#include <cmath>
+
+const int MineProbability::MAX_STEPS;
+const int MineProbability::MAX_COMPONENT_CELLS;
+
+namespace
+{
+
+/**
+ * Divides v by its maximum, only ratios between entries are ever used
+ */
+void normalize(std::vector<double>& v)
+{
+    const double max = *std::max_element(v.begin(), v.end());
+    if (max > 0)
+    {
+        for (double& x : v)
+            x /= max;
+    }
+}
+
+bool isCancelled(const std::atomic<bool>& cancelled)
+{
+    return cancelled.load(std::memory_order_relaxed);
+}
+
+}
+
+void MineProbability::setup(const MineSolver& solver)
+{
+    const MineField& field = *solver.m_field;
+    m_known = solver.m_known;
+    m_numCols = field.columnCount();
+    m_numUnknown = solver.unknownCount();
+    m_missingMines = solver.missingMinesCount();
+
+    m_constraints.clear();
+    m_constraints.reserve(solver.m_frontier.size());
+    for (int pos : solver.m_frontier)
+    {
+        Constraint constraint;
+        constraint.missing = solver.missingAround(pos);
+        field.forEachNeighbour(pos, [&](int n) {
+            if (m_known[n] == MineSolver::Unknown)
+                constraint.cells[constraint.count++] = n;
+        });
+        m_constraints.push_back(constraint);
+    }
+}
+
+bool MineProbability::compute(const std::atomic<bool>& cancelled, int maxSteps)
+{
+    m_approximate = false;
+    if (m_missingMines < 0)
+        return false;
+    buildComponents();
+    m_localCell.resize(m_frontierCells.size());
+    // the smallest components first, the steps go to the ones likely to finish
+    std::stable_sort(m_components.begin(), m_components.end(), [](const Component& a, const Component& b) {
+        return a.cells.size() < b.cells.size();
+    });
+    m_stepsLeft = maxSteps;
+    for (Component& component : m_components)
+    {
+        if (!enumerate(component, cancelled))
+            return false;
+    }
+
+    m_nodes.clear();
+    int root = -1;
+    std::vector<double> total(1, 1.0);
+    if (!m_components.empty())
+    {
+        root = buildTree(0, static_cast<int>(m_components.size()), cancelled);
+        if (root < 0)
+            return false;
+        total = m_nodes[root].distribution;
+    }
+
+    // with K mines on the frontier, the other ones can be placed
+    // in C(interior, missing - K) ways. Computed as log ratios of
+    // consecutive binomials, as the numbers themselves overflow easily
+    const int numInterior = m_numUnknown - static_cast<int>(m_frontierCells.size());
+    const int maxFrontierMines = static_cast<int>(total.size()) - 1;
+    const int first = std::max(0, m_missingMines - numInterior);
+    const int last = std::min(m_missingMines, maxFrontierMines);
+    if (first > last)
+        return false;
+    std::vector<double> logWeights(total.size(), 0);
+    for (int k = first + 1; k <= last; ++k)
+        logWeights[k] = logWeights[k - 1] + std::log(double(m_missingMines - k + 1)) - std::log(double(numInterior - m_missingMines + k));
+    double maxLog = -HUGE_VAL;
+    for (int k = first; k <= last; ++k)
+    {
+        if (total[k] > 0)
+            maxLog = std::max(maxLog, logWeights[k] + std::log(total[k]));
+    }
+    if (maxLog == -HUGE_VAL)
+        return false;
+    std::vector<double> weights(total.size(), 0);
+    double sum = 0;
+    double interiorSum = 0;
+    for (int k = first; k <= last; ++k)
+    {
+        // scaled so that the largest term of the sum is 1
+        weights[k] = std::exp(std::min(logWeights[k] - maxLog, 700.0));
+        sum += total[k]*weights[k];
+        if (numInterior > 0)
+            interiorSum += total[k]*weights[k]*(m_missingMines - k) / numInterior;
+    }
+    m_interiorProbability = interiorSum / sum;
+
+    m_frontierProbability.assign(m_frontierCells.size(), 0);
+    return root < 0 || pushDown(root, weights, cancelled);
+}
+
+double MineProbability::probability(int idx) const
+{
+    const int pos = toPadded(idx);
+    switch (m_known[pos])
+    {
+        case MineSolver::Unknown:
+        {
+            const int slot = frontierSlot(pos);
+            return slot < 0 ? m_interiorProbability : m_frontierProbability[slot];
+        }
+        case MineSolver::Mine:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+int MineProbability::frontierSlot(int pos) const
+{
+    const auto it = std::lower_bound(m_frontierCells.begin(), m_frontierCells.end(), pos);
+    if (it == m_frontierCells.end() || *it != pos)
+        return -1;
+    return static_cast<int>(it - m_frontierCells.begin());
+}
+
+void MineProbability::buildComponents()
+{
+    m_frontierCells.clear();
+    for (const Constraint& constraint : m_constraints)
+        m_frontierCells.insert(m_frontierCells.end(), constraint.cells, constraint.cells + constraint.count);
+    std::sort(m_frontierCells.begin(), m_frontierCells.end());
+    m_frontierCells.erase(std::unique(m_frontierCells.begin(), m_frontierCells.end()), m_frontierCells.end());
+
+    // constraints refer to cells by frontier slot from now on,
+    // cellStart/cellConstraints list the constraints of every slot
+    const int numCells = static_cast<int>(m_frontierCells.size());
+    const int numConstraints = static_cast<int>(m_constraints.size());
+    std::vector<int> cellStart(numCells + 1, 0);
+    for (Constraint& constraint : m_constraints)
+        for (int i = 0; i < constraint.count; ++i)
+        {
+            constraint.cells[i] = frontierSlot(constraint.cells[i]);
+            cellStart[constraint.cells[i] + 1]++;
+        }
+    for (int i = 0; i < numCells; ++i)
+        cellStart[i + 1] += cellStart[i];
+    std::vector<int> cellConstraints(cellStart.back());
+    std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+    for (int c = 0; c < numConstraints; ++c)
+        for (int i = 0; i < m_constraints[c].count; ++i)
+            cellConstraints[fill[m_constraints[c].cells[i]]++] = c;
+
+    // breadth first walks over constraints sharing cells: neighbouring
+    // cells get consecutive places, which keeps backtracking pruning early
+    m_components.clear();
+    std::vector<char> cellSeen(numCells, 0);
+    std::vector<char> constraintSeen(numConstraints, 0);
+    for (int start = 0; start < numConstraints; ++start)
+    {
+        if (constraintSeen[start])
+            continue;
+        m_components.emplace_back();
+        Component& component = m_components.back();
+        constraintSeen[start] = 1;
+        component.constraints.push_back(start);
+        for (std::size_t next = 0; next < component.constraints.size(); ++next)
+        {
+            const Constraint& constraint = m_constraints[component.constraints[next]];
+            for (int i = 0; i < constraint.count; ++i)
+            {
+                const int cell = constraint.cells[i];
+                if (cellSeen[cell])
+                    continue;
+                cellSeen[cell] = 1;
+                component.cells.push_back(cell);
+                for (int j = cellStart[cell]; j < cellStart[cell + 1]; ++j)
+                {
+                    const int c = cellConstraints[j];
+                    if (!constraintSeen[c])
+                    {
+                        constraintSeen[c] = 1;
+                        component.constraints.push_back(c);
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool MineProbability::enumerate(Component& component, const std::atomic<bool>& cancelled)
+{
+    const int numCells = static_cast<int>(component.cells.size());
+    // every solution costs a step per cell, and counts by cell take numCells^2 room
+    if (numCells > MAX_COMPONENT_CELLS || numCells > m_stepsLeft)
+    {
+        estimate(component);
+        return true;
+    }
+    const int numConstraints = static_cast<int>(component.constraints.size());
+    const int numCounts = std::min(numCells, m_missingMines) + 1;
+    component.counts.assign(numCounts, 0);
+    component.cellCounts.assign(numCells*numCounts, 0);
+
+    // component local numbering of cells and constraints
+    std::vector<int>& localCell = m_localCell;
+    for (int i = 0; i < numCells; ++i)
+        localCell[component.cells[i]] = i;
+    std::vector<int> missing(numConstraints);
+    std::vector<int> unassigned(numConstraints);
+    std::vector<int> mines(numConstraints, 0);
+    std::vector<int> cellStart(numCells + 1, 0);
+    for (int c = 0; c < numConstraints; ++c)
+    {
+        const Constraint& constraint = m_constraints[component.constraints[c]];
+        missing[c] = constraint.missing;
+        unassigned[c] = constraint.count;
+        for (int i = 0; i < constraint.count; ++i)
+            cellStart[localCell[constraint.cells[i]] + 1]++;
+    }
+    for (int i = 0; i < numCells; ++i)
+        cellStart[i + 1] += cellStart[i];
+    std::vector<int> cellConstraints(cellStart.back());
+    std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+    for (int c = 0; c < numConstraints; ++c)
+    {
+        const Constraint& constraint = m_constraints[component.constraints[c]];
+        for (int i = 0; i < constraint.count; ++i)
+            cellConstraints[fill[localCell[constraint.cells[i]]]++] = c;
+    }
+
+    // assigns value to cell, returns whether all its constraints can still be met
+    int numMines = 0;
+    const auto assign = [&](int cell, int value, int sign) {
+        bool feasible = true;
+        numMines += sign*value;
+        for (int j = cellStart[cell]; j < cellStart[cell + 1]; ++j)
+        {
+            const int c = cellConstraints[j];
+            unassigned[c] -= sign;
+            mines[c] += sign*value;
+            feasible = feasible && mines[c] <= missing[c] && mines[c] + unassigned[c] >= missing[c];
+        }
+        return feasible && numMines <= m_missingMines;
+    };
+
+    // iterative depth first search, tried[i] is 1 + the value cell i holds
+    std::vector<std::uint8_t> tried(numCells, 0);
+    unsigned steps = 0;
+    int cell = 0;
+    while (cell >= 0)
+    {
+        if (--m_stepsLeft < 0)
+        {
+            estimate(component);
+            return true;
+        }
+        if ((++steps & 0xffff) == 0 && isCancelled(cancelled))
+            return false;
+        if (cell == numCells)
+        {
+            m_stepsLeft -= numCells;
+            component.counts[numMines] += 1;
+            for (int i = 0; i < numCells; ++i)
+            {
+                if (tried[i] == 2)
+                    component.cellCounts[i*numCounts + numMines] += 1;
+            }
+            --cell;
+            continue;
+        }
+        if (tried[cell] != 0)
+            assign(cell, tried[cell] - 1, -1);
+        if (tried[cell] == 2)
+        {
+            tried[cell] = 0;
+            --cell;
+            continue;
+        }
+        const int value = tried[cell]++;
+        if (assign(cell, value, 1))
+            ++cell;
+    }
+
+    // no solution: what is known is contradictory
+    return std::any_of(component.counts.begin(), component.counts.end(), [](double n) { return n > 0; });
+}
+
+void MineProbability::estimate(Component& component)
+{
+    m_approximate = true;
+    const int numCells = static_cast<int>(component.cells.size());
+    for (int i = 0; i < numCells; ++i)
+        m_localCell[component.cells[i]] = i;
+
+    // the mean density of the digits around each cell
+    std::vector<int> numDigits(numCells, 0);
+    component.estimates.assign(numCells, 0);
+    for (int c : component.constraints)
+    {
+        const Constraint& constraint = m_constraints[c];
+        const double density = double(constraint.missing) / constraint.count;
+        for (int i = 0; i < constraint.count; ++i)
+        {
+            const int cell = m_localCell[constraint.cells[i]];
+            component.estimates[cell] += density;
+            ++numDigits[cell];
+        }
+    }
+    component.estimatedMines = 0;
+    for (int i = 0; i < numCells; ++i)
+    {
+        component.estimates[i] /= numDigits[i];
+        component.estimatedMines += component.estimates[i];
+    }
+
+    // mines counted as if cells of that density were independent,
+    // binomials computed in log space as in compute()
+    const int numCounts = std::min(numCells, m_missingMines) + 1;
+    const double density = component.estimatedMines / numCells;
+    component.counts.assign(numCounts, 0);
+    component.cellCounts.clear();
+    if (density <= 0 || density >= 1)
+    {
+        component.counts[density <= 0 ? 0 : numCounts - 1] = 1;
+        return;
+    }
+    std::vector<double> logCounts(numCounts, 0);
+    logCounts[0] = numCells*std::log(1 - density);
+    for (int k = 1; k < numCounts; ++k)
+        logCounts[k] = logCounts[k - 1] + std::log(double(numCells - k + 1) / k) + std::log(density / (1 - density));
+    const double maxLog = *std::max_element(logCounts.begin(), logCounts.end());
+    for (int k = 0; k < numCounts; ++k)
+        component.counts[k] = std::exp(logCounts[k] - maxLog);
+}
+
+int MineProbability::buildTree(int first, int last, const std::atomic<bool>& cancelled)
+{
+    // combines ranges of components two by two, so that pushDown() can give
+    // every component the weight of all the other ones in O(log) steps
+    Node node;
+    if (last - first == 1)
+    {
+        node.component = first;
+        node.distribution = m_components[first].counts;
+        normalize(node.distribution);
+    }
+    else
+    {
+        const int middle = (first + last) / 2;
+        node.left = buildTree(first, middle, cancelled);
+        node.right = buildTree(middle, last, cancelled);
+        if (node.left < 0 || node.right < 0 || isCancelled(cancelled))
+            return -1;
+        const std::vector<double>& left = m_nodes[node.left].distribution;
+        const std::vector<double>& right = m_nodes[node.right].distribution;
+        const std::size_t size = std::min<std::size_t>(left.size() + right.size() - 1, m_missingMines + 1);
+        node.distribution.assign(size, 0);
+        for (std::size_t i = 0; i < left.size(); ++i)
+            for (std::size_t j = 0; j < right.size() && i + j < size; ++j)
+                node.distribution[i + j] += left[i]*right[j];
+        normalize(node.distribution);
+    }
+    m_nodes.push_back(std::move(node));
+    return static_cast<int>(m_nodes.size()) - 1;
+}
+
+bool MineProbability::pushDown(int node, const std::vector<double>& context, const std::atomic<bool>& cancelled)
+{
+    if (isCancelled(cancelled))
+        return false;
+
+    // context[k] is the weight of the rest of the field when
+    // the components below node hold k mines
+    const Node& current = m_nodes[node];
+    if (current.component >= 0)
+    {
+        const Component& component = m_components[current.component];
+        const int numCounts = static_cast<int>(component.counts.size());
+        double sum = 0;
+        for (int k = 0; k < numCounts; ++k)
+            sum += component.counts[k]*context[k];
+        if (sum <= 0)
+            return false;
+        if (!component.estimates.empty())
+        {
+            // estimated cells keep their densities, scaled to the mines expected there
+            double expected = 0;
+            for (int k = 0; k < numCounts; ++k)
+                expected += k*component.counts[k]*context[k];
+            const double scale = component.estimatedMines > 0 ? expected / sum / component.estimatedMines : 0;
+            for (std::size_t i = 0; i < component.cells.size(); ++i)
+                m_frontierProbability[component.cells[i]] = std::min(1.0, component.estimates[i]*scale);
+            return true;
+        }
+        for (std::size_t i = 0; i < component.cells.size(); ++i)
+        {
+            double mined = 0;
+            for (int k = 0; k < numCounts; ++k)
+                mined += component.cellCounts[i*numCounts + k]*context[k];
+            m_frontierProbability[component.cells[i]] = mined / sum;
+        }
+        return true;
+    }
+
+    // the context of a child is the parent's one combined with its sibling
+    const auto childContext = [&](int child, int sibling) {
+        const std::vector<double>& distribution = m_nodes[sibling].distribution;
+        std::vector<double> result(m_nodes[child].distribution.size(), 0);
+        for (std::size_t k = 0; k < result.size(); ++k)
+            for (std::size_t i = 0; i < distribution.size() && k + i < context.size(); ++i)
+                result[k] += distribution[i]*context[k + i];
+        normalize(result);
+        return result;
+    };
+    const int left = current.left;
+    const int right = current.right;
+    return pushDown(left, childContext(left, right), cancelled)
+        && pushDown(right, childContext(right, left), cancelled);
+}
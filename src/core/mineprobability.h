@@ -0,0 +1,193 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef MINEPROBABILITY_H
+#define MINEPROBABILITY_H
+
+// own
+#include "minesolver.h"
+// Std
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Exact mine probabilities of all unknown cells.
+ *
+ * setup() copies what a MineSolver knows, so compute() can then run on any
+ * thread while the game goes on. Unknown cells touching revealed digits
+ * (the frontier) are split into independent components: cells of two
+ * components never share a digit. The solutions of every component are
+ * enumerated by backtracking and counted by number of mines. Components are
+ * then combined with the cells touching no digit: a configuration with K
+ * frontier mines has C(interior, remaining - K) ways to place the other mines.
+ *
+ * Binomial weights are computed in log space and solution counts are kept
+ * as rescaled doubles, so the result stays exact (up to rounding) whatever
+ * the size of the field.
+ *
+ * Enumerating is exponential in the worst case, so compute() has a budget
+ * of backtracking steps, spent on the smallest components first. Components
+ * it can't afford, or too large to count by cell, are estimated instead:
+ * their cells get the density of the digits around them, scaled to the
+ * number of mines the rest of the field leaves them. isApproximate() tells
+ * when this happened.
+ */
+class MineProbability
+{
+public:
+    /**
+     * Default number of backtracking steps of a compute() call,
+     * a fraction of a second
+     */
+    static const int MAX_STEPS = 1 << 22;
+    /**
+     * Components with more cells are estimated without enumerating them
+     */
+    static const int MAX_COMPONENT_CELLS = 512;
+
+    /**
+     * Copies the knowledge of solver, which must be up to date
+     */
+    void setup(const MineSolver& solver);
+    /**
+     * Computes probabilities, checking cancelled from time to time
+     *
+     * @param maxSteps backtracking steps allowed, components left when they
+     * are spent are estimated
+     * @return false if cancelled or if the known cells contradict each other
+     */
+    bool compute(const std::atomic<bool>& cancelled, int maxSteps = MAX_STEPS);
+    /**
+     * @return whether some components were estimated instead of enumerated
+     * by the last compute()
+     */
+    bool isApproximate() const { return m_approximate; }
+    /**
+     * @return probability that the cell at idx holds a mine, valid after compute()
+     */
+    double probability(int idx) const;
+    /**
+     * @return probability of cells not touching any revealed digit
+     */
+    double interiorProbability() const { return m_interiorProbability; }
+    /**
+     * @return the unknown cell least likely to hold a mine among the ones
+     * for which accept(idx) is true, or -1. Valid after compute()
+     */
+    template<typename Accept>
+    int safestCell(Accept accept) const;
+
+private:
+    struct Constraint
+    {
+        int cells[8];
+        int count = 0;
+        int missing = 0;
+    };
+    struct Component
+    {
+        std::vector<int> cells;
+        std::vector<int> constraints;
+        /**
+         * Number of solutions by number of mines
+         */
+        std::vector<double> counts;
+        /**
+         * Number of solutions by cell and number of mines, (counts.size() per cell)
+         */
+        std::vector<double> cellCounts;
+        /**
+         * For estimated components, the density around every cell and their sum.
+         * cellCounts is empty then
+         */
+        std::vector<double> estimates;
+        double estimatedMines = 0;
+    };
+    struct Node
+    {
+        /**
+         * Rescaled number of solutions by number of mines of a range of components
+         */
+        std::vector<double> distribution;
+        int left = -1;
+        int right = -1;
+        int component = -1;
+    };
+
+    int toPadded(int idx) const { return idx + 2*(idx / m_numCols) + m_numCols + 3; }
+    int toIndex(int pos) const { return pos - 2*(pos / (m_numCols + 2)) - m_numCols - 1; }
+    int frontierSlot(int pos) const;
+    void buildComponents();
+    /**
+     * Counts the solutions of component, or estimates it once the steps are spent
+     *
+     * @return false if cancelled or if the component has no solution
+     */
+    bool enumerate(Component& component, const std::atomic<bool>& cancelled);
+    void estimate(Component& component);
+    int buildTree(int first, int last, const std::atomic<bool>& cancelled);
+    bool pushDown(int node, const std::vector<double>& context, const std::atomic<bool>& cancelled);
+
+    std::vector<std::uint8_t> m_known;
+    std::vector<Constraint> m_constraints;
+    int m_numCols = 0;
+    int m_numUnknown = 0;
+    int m_missingMines = 0;
+
+    /**
+     * Sorted positions of the frontier cells and their probabilities
+     */
+    std::vector<int> m_frontierCells;
+    std::vector<double> m_frontierProbability;
+    std::vector<Component> m_components;
+    std::vector<Node> m_nodes;
+    /**
+     * Component local number of frontier cells, used by enumerate()
+     */
+    std::vector<int> m_localCell;
+    double m_interiorProbability = 0;
+    /**
+     * Backtracking steps left to compute()
+     */
+    long long m_stepsLeft = 0;
+    bool m_approximate = false;
+};
+
+template<typename Accept>
+int MineProbability::safestCell(Accept accept) const
+{
+    int best = -1;
+    double bestProbability = 2;
+    for (std::size_t slot = 0; slot < m_frontierCells.size(); ++slot)
+    {
+        const int idx = toIndex(m_frontierCells[slot]);
+        if (m_frontierProbability[slot] < bestProbability && accept(idx))
+        {
+            best = idx;
+            bestProbability = m_frontierProbability[slot];
+        }
+    }
+    if (m_interiorProbability >= bestProbability)
+        return best;
+
+    // any cell touching no digit, skipping the (sorted) frontier ones
+    std::size_t slot = 0;
+    for (int pos = 0; pos < static_cast<int>(m_known.size()); ++pos)
+    {
+        if (m_known[pos] != MineSolver::Unknown)
+            continue;
+        while (slot < m_frontierCells.size() && m_frontierCells[slot] < pos)
+            ++slot;
+        if (slot < m_frontierCells.size() && m_frontierCells[slot] == pos)
+            continue;
+        if (accept(toIndex(pos)))
+            return toIndex(pos);
+    }
+    return best;
+}
+
+#endif
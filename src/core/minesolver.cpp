@@ -0,0 +1,334 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "minesolver.h"
+
+// own
+#include "minefield.h"
+// Std
+#include <algorithm>
+
+void MineSolver::reset(const MineField& field)
+{
+    m_field = &field;
+    const std::size_t paddedSize = field.m_content.size();
+    m_known.assign(paddedSize, Border);
+    m_unknownAround.assign(paddedSize, 0);
+    m_minesAround.assign(paddedSize, 0);
+    field.forEachCell([&](int pos) {
+        m_known[pos] = Unknown;
+        field.forEachNeighbour(pos, [this](int n) { m_unknownAround[n]++; });
+    });
+    m_queued.assign(paddedSize, 0);
+    m_frontierIndex.assign(paddedSize, -1);
+    m_stamp.assign(paddedSize, 0);
+    m_stampValue = 0;
+    m_queue.clear();
+    m_revealStack.clear();
+    m_safeCells.clear();
+    m_frontier.clear();
+    m_numUnknown = field.cellCount();
+    m_numMines = 0;
+    m_numRevealed = 0;
+    m_autoReveal = false;
+}
+
+void MineSolver::cellRevealed(int idx)
+{
+    const int pos = m_field->toPadded(idx);
+    // revealing a mine ends the game, there is nothing left to advise
+    if (!(m_field->m_content[pos] & MineField::MineBit))
+        reveal(pos);
+}
+
+void MineSolver::update()
+{
+    do {
+        while (!m_queue.empty() || !m_revealStack.empty())
+        {
+            if (!m_revealStack.empty())
+            {
+                const int pos = m_revealStack.back();
+                m_revealStack.pop_back();
+                reveal(pos);
+                continue;
+            }
+            const int pos = m_queue.back();
+            m_queue.pop_back();
+            m_queued[pos] = 0;
+            evaluate(pos);
+        }
+    } while (applyMineCountRule());
+}
+
+MineSolver::Knowledge MineSolver::knowledge(int idx) const
+{
+    return static_cast<Knowledge>(m_known[m_field->toPadded(idx)]);
+}
+
+bool MineSolver::isSafe(int idx) const
+{
+    const Knowledge known = knowledge(idx);
+    return known == Safe || known == Revealed;
+}
+
+bool MineSolver::isMine(int idx) const
+{
+    return knowledge(idx) == Mine;
+}
+
+int MineSolver::safeCell()
+{
+    // cells revealed since their deduction are dropped lazily
+    while (!m_safeCells.empty())
+    {
+        const int pos = m_safeCells.back();
+        if (m_known[pos] == Safe)
+            return m_field->toIndex(pos);
+        m_safeCells.pop_back();
+    }
+    return -1;
+}
+
+int MineSolver::unmarkedSafeCell()
+{
+    if (safeCell() < 0)
+        return -1;
+    // the latest deductions first, like safeCell()
+    for (auto it = m_safeCells.rbegin(); it != m_safeCells.rend(); ++it) {
+        if (m_known[*it] == Safe && m_field->cellState(*it) == KMinesState::Released)
+            return m_field->toIndex(*it);
+    }
+    return -1;
+}
+
+int MineSolver::missingMinesCount() const
+{
+    return m_field->minesCount() - m_numMines;
+}
+
+std::vector<int> MineSolver::frontier() const
+{
+    std::vector<int> result;
+    result.reserve(m_frontier.size());
+    for (int pos : m_frontier)
+        result.push_back(m_field->toIndex(pos));
+    return result;
+}
+
+bool MineSolver::solve(const MineField& field, int startIdx)
+{
+    reset(field);
+    m_autoReveal = true;
+    m_revealStack.push_back(field.toPadded(startIdx));
+    update();
+    return m_numRevealed == field.cellCount() - field.minesCount();
+}
+
+void MineSolver::setKnown(int pos, Knowledge knowledge)
+{
+    if (m_known[pos] == Unknown)
+    {
+        // only digits around the cell are affected
+        const bool mine = knowledge == Mine;
+        m_numUnknown--;
+        m_numMines += mine;
+        m_field->forEachNeighbour(pos, [&](int n) {
+            m_unknownAround[n]--;
+            m_minesAround[n] += mine;
+            if (m_known[n] == Revealed)
+            {
+                if (m_unknownAround[n] == 0)
+                    removeFromFrontier(n);
+                queue(n);
+            }
+        });
+    }
+    m_known[pos] = knowledge;
+}
+
+void MineSolver::markSafe(int pos)
+{
+    if (m_known[pos] != Unknown)
+        return;
+    setKnown(pos, Safe);
+    if (m_autoReveal)
+        m_revealStack.push_back(pos);
+    else
+        m_safeCells.push_back(pos);
+}
+
+void MineSolver::markMine(int pos)
+{
+    if (m_known[pos] == Unknown)
+        setKnown(pos, Mine);
+}
+
+void MineSolver::reveal(int pos)
+{
+    if (m_known[pos] != Unknown && m_known[pos] != Safe)
+        return;
+    setKnown(pos, Revealed);
+    m_numRevealed++;
+    if (m_unknownAround[pos] != 0)
+        addToFrontier(pos);
+    queue(pos);
+}
+
+void MineSolver::queue(int pos)
+{
+    if (!m_queued[pos])
+    {
+        m_queued[pos] = 1;
+        m_queue.push_back(pos);
+    }
+}
+
+int MineSolver::missingAround(int pos) const
+{
+    return (m_field->m_content[pos] & MineField::DigitMask) - m_minesAround[pos];
+}
+
+void MineSolver::evaluate(int pos)
+{
+    const int unknown = m_unknownAround[pos];
+    if (unknown == 0)
+        return;
+
+    const int missing = missingAround(pos);
+    if (missing == 0 || missing == unknown)
+    {
+        const bool mines = missing != 0;
+        m_field->forEachNeighbour(pos, [&](int n) {
+            if (mines)
+                markMine(n);
+            else
+                markSafe(n);
+        });
+        return;
+    }
+
+    // digits sharing unknown neighbours with pos are at most 2 cells away.
+    // A pair only gives something new when one of its digits changed,
+    // so looking at the pairs of queued digits is enough
+    const int stride = m_field->m_stride;
+    const int size = static_cast<int>(m_known.size());
+    for (int dr = -2; dr <= 2; ++dr)
+        for (int dc = -2; dc <= 2; ++dc)
+        {
+            const int other = pos + dr*stride + dc;
+            if (other == pos || other < 0 || other >= size)
+                continue;
+            if (m_known[other] == Revealed && m_unknownAround[other] != 0 && evaluatePair(pos, other))
+            {
+                // the deduction may only mark cells around other, the
+                // remaining pairs of pos are tried when it comes again
+                queue(pos);
+                return;
+            }
+        }
+}
+
+bool MineSolver::evaluatePair(int a, int b)
+{
+    const int stampA = ++m_stampValue;
+    const int stampShared = ++m_stampValue;
+    m_field->forEachNeighbour(a, [&](int n) {
+        if (m_known[n] == Unknown)
+            m_stamp[n] = stampA;
+    });
+    int shared = 0;
+    m_field->forEachNeighbour(b, [&](int n) {
+        if (m_known[n] == Unknown && m_stamp[n] == stampA)
+        {
+            m_stamp[n] = stampShared;
+            shared++;
+        }
+    });
+    if (shared == 0)
+        return false;
+
+    // bounds of the number of mines among shared cells give
+    // the number of mines among the cells only a or only b sees
+    const int onlyA = m_unknownAround[a] - shared;
+    const int onlyB = m_unknownAround[b] - shared;
+    const int missingA = missingAround(a);
+    const int missingB = missingAround(b);
+    const int minShared = std::max({ 0, missingA - onlyA, missingB - onlyB });
+    const int maxShared = std::min({ shared, missingA, missingB });
+
+    const bool safeA = onlyA != 0 && minShared == missingA;
+    const bool minesA = onlyA != 0 && missingA - maxShared == onlyA;
+    const bool safeB = onlyB != 0 && minShared == missingB;
+    const bool minesB = onlyB != 0 && missingB - maxShared == onlyB;
+    if (!safeA && !minesA && !safeB && !minesB)
+        return false;
+
+    // collect both sides first, marking cells changes their knowledge
+    int cellsA[8];
+    int cellsB[8];
+    int countA = 0;
+    int countB = 0;
+    m_field->forEachNeighbour(a, [&](int n) {
+        if (m_known[n] == Unknown && m_stamp[n] == stampA)
+            cellsA[countA++] = n;
+    });
+    m_field->forEachNeighbour(b, [&](int n) {
+        if (m_known[n] == Unknown && m_stamp[n] != stampShared)
+            cellsB[countB++] = n;
+    });
+    for (int i = 0; i < countA; ++i)
+    {
+        if (safeA)
+            markSafe(cellsA[i]);
+        else if (minesA)
+            markMine(cellsA[i]);
+    }
+    for (int i = 0; i < countB; ++i)
+    {
+        if (safeB)
+            markSafe(cellsB[i]);
+        else if (minesB)
+            markMine(cellsB[i]);
+    }
+    return true;
+}
+
+bool MineSolver::applyMineCountRule()
+{
+    // when all mines are found every unknown cell is safe,
+    // when there are as many unknown cells as missing mines they are all mined
+    const int missing = missingMinesCount();
+    if (m_numUnknown == 0 || (missing != 0 && missing != m_numUnknown))
+        return false;
+    m_field->forEachCell([&](int pos) {
+        if (missing == 0)
+            markSafe(pos);
+        else
+            markMine(pos);
+    });
+    return true;
+}
+
+void MineSolver::addToFrontier(int pos)
+{
+    if (m_frontierIndex[pos] >= 0)
+        return;
+    m_frontierIndex[pos] = static_cast<int>(m_frontier.size());
+    m_frontier.push_back(pos);
+}
+
+void MineSolver::removeFromFrontier(int pos)
+{
+    const int i = m_frontierIndex[pos];
+    if (i < 0)
+        return;
+    const int last = m_frontier.back();
+    m_frontier[i] = last;
+    m_frontierIndex[last] = i;
+    m_frontier.pop_back();
+    m_frontierIndex[pos] = -1;
+}
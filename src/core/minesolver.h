@@ -0,0 +1,165 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef MINESOLVER_H
+#define MINESOLVER_H
+
+// Std
+#include <cstdint>
+#include <vector>
+
+class MineField;
+
+/**
+ * Incremental minesweeper solver and adviser.
+ *
+ * The solver knows what the player knows: which cells are revealed and
+ * their digits. From that it deduces safe cells and mines using only
+ * safe rules: trivial ones (a digit is satisfied, or all its unknown
+ * neighbours must be mines), pairwise ones between overlapping digits
+ * (which include the subset rule), and the total mine count.
+ *
+ * It keeps, for every cell, the number of unknown cells and of known mines
+ * around it, and the frontier of revealed digits which still touch unknown
+ * cells. Revealing a cell only re-evaluates the digits around the cells
+ * whose knowledge changed, so an update costs O(changed cells), whatever
+ * the size of the field.
+ *
+ * Flags set by the player are not used: they may be wrong, and advice based
+ * on them could lead the player onto a mine.
+ */
+class MineSolver
+{
+public:
+    enum Knowledge : std::uint8_t { Unknown, Safe, Revealed, Mine, Border };
+
+    /**
+     * Starts following a new game on field, with nothing revealed.
+     * The field must outlive the solver or the next reset()
+     */
+    void reset(const MineField& field);
+    /**
+     * Tells the solver that the player revealed the cell at idx.
+     * Deductions are made by the next update()
+     */
+    void cellRevealed(int idx);
+    /**
+     * Runs deductions for all changes since the last update
+     */
+    void update();
+
+    Knowledge knowledge(int idx) const;
+    /**
+     * @return whether cell at idx was deduced to be safe or is revealed
+     */
+    bool isSafe(int idx) const;
+    /**
+     * @return whether cell at idx was deduced to hold a mine
+     */
+    bool isMine(int idx) const;
+    /**
+     * @return an unrevealed cell known to be safe, or -1 if there is none
+     */
+    int safeCell();
+    /**
+     * @return an unrevealed cell known to be safe which the player
+     * didn't mark, or -1 if there is none
+     */
+    int unmarkedSafeCell();
+    /**
+     * @return number of cells not known to be safe or mined
+     */
+    int unknownCount() const { return m_numUnknown; }
+    /**
+     * @return number of cells deduced to hold a mine
+     */
+    int knownMinesCount() const { return m_numMines; }
+    /**
+     * @return number of mines of the field not deduced yet
+     */
+    int missingMinesCount() const;
+    /**
+     * Revealed digits which still have unknown neighbours, by index
+     */
+    std::vector<int> frontier() const;
+
+    /**
+     * Plays field starting by revealing the empty cell startIdx, revealing
+     * every cell as soon as it is deduced to be safe.
+     *
+     * @return whether all safe cells could be revealed without guessing
+     */
+    bool solve(const MineField& field, int startIdx);
+
+private:
+    friend class MineProbability;
+
+    /**
+     * Changes knowledge of cell at pos, updating counters of the digits around
+     */
+    void setKnown(int pos, Knowledge knowledge);
+    void markSafe(int pos);
+    void markMine(int pos);
+    /**
+     * Turns a safe or unknown cell into a revealed digit
+     */
+    void reveal(int pos);
+    void queue(int pos);
+    /**
+     * Applies the trivial and pairwise rules on the digit at pos
+     */
+    void evaluate(int pos);
+    /**
+     * Applies the pairwise rule on digits at a and b
+     *
+     * @return whether something was deduced
+     */
+    bool evaluatePair(int a, int b);
+    /**
+     * Uses the number of remaining mines
+     */
+    bool applyMineCountRule();
+    int missingAround(int pos) const;
+    void addToFrontier(int pos);
+    void removeFromFrontier(int pos);
+
+    const MineField* m_field = nullptr;
+    /**
+     * What is known about each cell, in MineField padded layout
+     */
+    std::vector<std::uint8_t> m_known;
+    /**
+     * Number of unknown cells and of known mines around each cell
+     */
+    std::vector<std::uint8_t> m_unknownAround;
+    std::vector<std::uint8_t> m_minesAround;
+    /**
+     * Digits to re-evaluate
+     */
+    std::vector<int> m_queue;
+    std::vector<std::uint8_t> m_queued;
+    /**
+     * Cells to reveal, in solve() mode
+     */
+    std::vector<int> m_revealStack;
+    /**
+     * Deduced safe cells, some of them may be revealed since
+     */
+    std::vector<int> m_safeCells;
+    std::vector<int> m_frontier;
+    std::vector<int> m_frontierIndex;
+    std::vector<int> m_stamp;
+    int m_stampValue = 0;
+    int m_numUnknown = 0;
+    int m_numMines = 0;
+    int m_numRevealed = 0;
+    /**
+     * Whether deduced safe cells get revealed right away
+     */
+    bool m_autoReveal = false;
+};
+
+#endif
@@ -0,0 +1,88 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "noguessgenerator.h"
+
+// own
+#include "counterrandom.h"
+#include "minefield.h"
+#include "minesolver.h"
+// Std
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+const int NoGuessGenerator::MAX_CANDIDATES;
+const int NoGuessGenerator::TIMEOUT_MS;
+
+bool NoGuessGenerator::generate(MineField& field, int clickedIdx, std::uint64_t seed, int timeoutMs)
+{
+    const int found = search(field.rowCount(), field.columnCount(), field.minesCount(), clickedIdx, seed,
+                             0, nullptr, timeoutMs);
+    if (found < 0)
+    {
+        field.generate(clickedIdx, seed);
+        return false;
+    }
+    field.generate(clickedIdx, candidateSeed(seed, found));
+    return true;
+}
+
+int NoGuessGenerator::search(int numRows, int numCols, int numMines, int clickedIdx, std::uint64_t seed,
+                             int numThreads, const std::atomic<bool>* cancelled, int timeoutMs)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    // candidates are claimed in order; once one passes, only the lower
+    // numbered candidates still being tried can replace it
+    std::atomic<int> nextCandidate(0);
+    std::atomic<int> bestCandidate(MAX_CANDIDATES);
+    const auto search = [&]() {
+        MineField candidate;
+        MineSolver solver;
+        while (true)
+        {
+            const int n = nextCandidate++;
+            if (n >= bestCandidate.load() || (cancelled && cancelled->load()))
+                break;
+            if (timeoutMs > 0 && bestCandidate.load() == MAX_CANDIDATES && std::chrono::steady_clock::now() > deadline)
+                break;
+
+            candidate.init(numRows, numCols, numMines);
+            candidate.generate(clickedIdx, candidateSeed(seed, n));
+            if (solver.solve(candidate, clickedIdx))
+            {
+                int best = bestCandidate.load();
+                while (n < best && !bestCandidate.compare_exchange_weak(best, n)) {
+                }
+            }
+        }
+    };
+
+    if (numThreads <= 0)
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numThreads; ++i)
+        threads.emplace_back(search);
+    search();
+    for (std::thread& thread : threads)
+        thread.join();
+
+    const int found = bestCandidate.load();
+    if (found == MAX_CANDIDATES || (cancelled && cancelled->load()))
+        return -1;
+    return found;
+}
+
+std::uint64_t NoGuessGenerator::candidateSeed(std::uint64_t seed, int candidate)
+{
+    // hashed, so that neighbouring candidates get unrelated seeds
+    if (candidate == 0)
+        return seed;
+    return CounterRandom(seed).at(candidate);
+}
@@ -0,0 +1,67 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef NOGUESSGENERATOR_H
+#define NOGUESSGENERATOR_H
+
+// Std
+#include <atomic>
+#include <cstdint>
+
+class MineField;
+
+/**
+ * Generates fields which can be solved from the first click without guessing.
+ *
+ * Random candidate fields are generated and played by MineSolver on all
+ * cores in parallel. Candidates are numbered and each one is generated from
+ * its own seed, and the lowest numbered candidate which passes is taken,
+ * so the result only depends on the seed, not on thread timing.
+ */
+class NoGuessGenerator
+{
+public:
+    /**
+     * Maximal number of candidates tried before giving up
+     */
+    static const int MAX_CANDIDATES = 100000;
+    /**
+     * Time after which the search gives up, if nothing was found yet
+     */
+    static const int TIMEOUT_MS = 2000;
+
+    /**
+     * Generates an initialized field so that it is solvable from clickedIdx.
+     * If no such field is found, a regular field is generated instead.
+     * MineField::origin() tells the seed of the candidate taken.
+     *
+     * @param timeoutMs as for search()
+     * @return whether the generated field is solvable without guessing
+     */
+    static bool generate(MineField& field, int clickedIdx, std::uint64_t seed, int timeoutMs = TIMEOUT_MS);
+    /**
+     * Searches a candidate solvable from clickedIdx on a field of the given size,
+     * as generate() does. Generating a field from candidateSeed(seed, result)
+     * and clickedIdx gives the found field.
+     *
+     * @param numThreads number of threads trying candidates, 0 for all cores
+     * @param cancelled if not null, the search gives up once it is set
+     * @param timeoutMs time after which the search gives up if nothing was
+     * found yet, 0 for no limit: only MAX_CANDIDATES bounds the search then,
+     * so its result only depends on the seed, whatever the machine load
+     * @return number of the found candidate, -1 if none was found
+     */
+    static int search(int numRows, int numCols, int numMines, int clickedIdx, std::uint64_t seed,
+                      int numThreads = 0, const std::atomic<bool>* cancelled = nullptr,
+                      int timeoutMs = TIMEOUT_MS);
+    /**
+     * @return seed of the n-th candidate for a search seed. The first
+     * candidate is the field of the seed itself
+     */
+    static std::uint64_t candidateSeed(std::uint64_t seed, int candidate);
+};
+
+#endif
@@ -0,0 +1,167 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "simulator.h"
+
+// own
+#include "counterrandom.h"
+#include "minefield.h"
+#include "mineprobability.h"
+#include "minesolver.h"
+#include "noguessgenerator.h"
+#include "workstealingpool.h"
+// Std
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace
+{
+
+void count(std::vector<int>& histogram, int value)
+{
+    if (static_cast<int>(histogram.size()) <= value)
+        histogram.resize(value + 1, 0);
+    ++histogram[value];
+}
+
+}
+
+/**
+ * Plays games of one thread, reusing its field and solver
+ */
+class Simulator::Player
+{
+public:
+    explicit Player(const Simulator* simulator)
+        : m_simulator(simulator)
+    {
+    }
+
+    void play(int game)
+    {
+        const Simulator& s = *m_simulator;
+        CounterRandom random(CounterRandom(s.m_seed).at(game));
+        const int clickedIdx = static_cast<int>(random.bounded(s.m_numRows*s.m_numCols));
+        const std::uint64_t fieldSeed = random.next();
+
+        m_field.init(s.m_numRows, s.m_numCols, s.m_numMines);
+        if (s.m_generator == RandomFields)
+            m_field.generate(clickedIdx, fieldSeed);
+        else
+        {
+            // one thread per game, games already use all of them.
+            // No time limit, so the field doesn't depend on the machine load
+            const int found = NoGuessGenerator::search(s.m_numRows, s.m_numCols, s.m_numMines,
+                                                       clickedIdx, fieldSeed, 1, nullptr, 0);
+            if (found < 0)
+                ++statistics.noGuessFailures;
+            m_field.generate(clickedIdx, found < 0 ? fieldSeed : NoGuessGenerator::candidateSeed(fieldSeed, found));
+        }
+        m_solver.reset(m_field);
+
+        int guesses = 0;
+        MineField::GameResult result = reveal(clickedIdx);
+        while (result == MineField::GameContinues)
+        {
+            int idx = m_solver.safeCell();
+            if (idx < 0)
+            {
+                ++guesses;
+                idx = guess();
+            }
+            result = reveal(idx);
+        }
+
+        ++statistics.games;
+        statistics.won += result == MineField::GameWon;
+        count(statistics.guesses, guesses);
+        count(statistics.bbbv, m_field.bbbv());
+    }
+
+    Statistics statistics;
+
+private:
+    MineField::GameResult reveal(int idx)
+    {
+        const MineField::GameResult result = m_field.reveal(idx);
+        if (result == MineField::GameContinues)
+        {
+            for (int changed : m_field.changedCells()) {
+                if (m_field.isRevealed(changed))
+                    m_solver.cellRevealed(changed);
+            }
+            m_solver.update();
+        }
+        m_field.clearChanges();
+        return result;
+    }
+
+    /**
+     * @return the unrevealed cell least likely to hold a mine
+     */
+    int guess()
+    {
+        // never cancelled, the step budget of compute() bounds each guess
+        const std::atomic<bool> cancelled(false);
+        m_probability.setup(m_solver);
+        int idx = -1;
+        if (m_probability.compute(cancelled))
+        {
+            statistics.approximateGuesses += m_probability.isApproximate();
+            idx = m_probability.safestCell([this](int cell) {
+                return !m_field.isRevealed(cell) && !m_solver.isMine(cell);
+            });
+        }
+        // the known cells can't contradict each other, but just in case
+        for (int cell = 0; idx < 0 && cell < m_field.cellCount(); ++cell) {
+            if (!m_field.isRevealed(cell) && !m_solver.isMine(cell))
+                idx = cell;
+        }
+        return idx;
+    }
+
+    const Simulator* m_simulator;
+    MineField m_field;
+    MineSolver m_solver;
+    MineProbability m_probability;
+};
+
+void Simulator::Statistics::merge(const Statistics& other)
+{
+    games += other.games;
+    won += other.won;
+    noGuessFailures += other.noGuessFailures;
+    approximateGuesses += other.approximateGuesses;
+    guesses.resize(std::max(guesses.size(), other.guesses.size()), 0);
+    for (std::size_t i = 0; i < other.guesses.size(); ++i)
+        guesses[i] += other.guesses[i];
+    bbbv.resize(std::max(bbbv.size(), other.bbbv.size()), 0);
+    for (std::size_t i = 0; i < other.bbbv.size(); ++i)
+        bbbv[i] += other.bbbv[i];
+}
+
+Simulator::Simulator(int numRows, int numCols, int numMines, Generator generator, std::uint64_t seed)
+    : m_numRows(numRows), m_numCols(numCols), m_numMines(numMines), m_generator(generator), m_seed(seed)
+{
+}
+
+Simulator::Statistics Simulator::run(int numGames, WorkStealingPool& pool) const
+{
+    // separate allocations, threads never write next to each other
+    std::vector<std::unique_ptr<Player> > players;
+    for (int worker = 0; worker < pool.threadCount(); ++worker)
+        players.emplace_back(new Player(this));
+
+    pool.run(numGames, [&players](int worker, int game) {
+        players[worker]->play(game);
+    });
+
+    Statistics statistics;
+    for (const std::unique_ptr<Player>& player : players)
+        statistics.merge(player->statistics);
+    return statistics;
+}
@@ -0,0 +1,75 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+// Std
+#include <cstdint>
+#include <vector>
+
+class WorkStealingPool;
+
+/**
+ * Plays many games with a built-in strategy, to tell how hard a field size
+ * is or to check generator changes.
+ *
+ * The strategy reveals every cell MineSolver deduces to be safe and, when
+ * there is none, guesses the cell MineProbability finds least likely to
+ * hold a mine, estimated when the frontier is too large to enumerate. Game
+ * n is generated from CounterRandom(seed).at(n), first click included, so
+ * results don't depend on the number of threads.
+ */
+class Simulator
+{
+public:
+    enum Generator { RandomFields, NoGuessFields };
+
+    struct Statistics
+    {
+        int games = 0;
+        int won = 0;
+        /**
+         * Number of games by number of guesses played, the last one
+         * included in lost games
+         */
+        std::vector<int> guesses;
+        /**
+         * Number of games by 3BV of their field
+         */
+        std::vector<int> bbbv;
+        /**
+         * Number of no-guess searches which failed, giving a random field.
+         * Searches have no time limit, they only fail after
+         * NoGuessGenerator::MAX_CANDIDATES candidates
+         */
+        int noGuessFailures = 0;
+        /**
+         * Number of guesses made from estimated probabilities, when
+         * enumerating the frontier took more than MineProbability::MAX_STEPS
+         */
+        int approximateGuesses = 0;
+
+        void merge(const Statistics& other);
+    };
+
+    Simulator(int numRows, int numCols, int numMines, Generator generator, std::uint64_t seed);
+    /**
+     * Plays games 0 up to numGames - 1 on all threads of pool
+     */
+    Statistics run(int numGames, WorkStealingPool& pool) const;
+
+private:
+    class Player;
+
+    int m_numRows;
+    int m_numCols;
+    int m_numMines;
+    Generator m_generator;
+    std::uint64_t m_seed;
+};
+
+#endif
@@ -0,0 +1,130 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "workstealingpool.h"
+
+// Std
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(int numThreads)
+    : m_numThreads(numThreads > 0 ? numThreads : std::max(1, static_cast<int>(std::thread::hardware_concurrency())))
+    , m_ranges(new Range[m_numThreads])
+{
+    for (int worker = 0; worker < m_numThreads; ++worker)
+        m_ranges[worker].bounds.store(0);
+    for (int worker = 1; worker < m_numThreads; ++worker)
+        m_threads.emplace_back([this, worker]() { threadMain(worker); });
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_started.notify_all();
+    for (std::thread& thread : m_threads)
+        thread.join();
+}
+
+void WorkStealingPool::run(int count, const std::function<void(int, int)>& body)
+{
+    if (count <= 0)
+        return;
+
+    // neighbouring items stay on the same thread until it steals
+    for (int worker = 0; worker < m_numThreads; ++worker) {
+        const std::uint32_t begin = static_cast<std::uint32_t>(static_cast<std::int64_t>(count)*worker / m_numThreads);
+        const std::uint32_t end = static_cast<std::uint32_t>(static_cast<std::int64_t>(count)*(worker + 1) / m_numThreads);
+        m_ranges[worker].bounds.store(pack(begin, end));
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_body = &body;
+        m_running = m_numThreads - 1;
+        ++m_generation;
+    }
+    m_started.notify_all();
+
+    work(0, body);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this]() { return m_running == 0; });
+    m_body = nullptr;
+}
+
+void WorkStealingPool::threadMain(int worker)
+{
+    int generation = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_started.wait(lock, [this, generation]() { return m_stopping || m_generation != generation; });
+        if (m_stopping)
+            return;
+        generation = m_generation;
+        const std::function<void(int, int)>* body = m_body;
+
+        lock.unlock();
+        work(worker, *body);
+        lock.lock();
+
+        if (--m_running == 0)
+            m_finished.notify_one();
+    }
+}
+
+void WorkStealingPool::work(int worker, const std::function<void(int, int)>& body)
+{
+    int item;
+    while (takeFront(worker, &item) || steal(worker, &item))
+        body(worker, item);
+}
+
+bool WorkStealingPool::takeFront(int worker, int* item)
+{
+    std::atomic<std::uint64_t>& bounds = m_ranges[worker].bounds;
+    std::uint64_t current = bounds.load();
+    while (true)
+    {
+        const std::uint32_t begin = static_cast<std::uint32_t>(current >> 32);
+        const std::uint32_t end = static_cast<std::uint32_t>(current);
+        if (begin >= end)
+            return false;
+        // thieves only move end, so this rarely fails
+        if (bounds.compare_exchange_weak(current, pack(begin + 1, end)))
+        {
+            *item = static_cast<int>(begin);
+            return true;
+        }
+    }
+}
+
+bool WorkStealingPool::steal(int worker, int* item)
+{
+    // no items are ever added, once all ranges are seen empty the loop is done
+    for (int i = 1; i < m_numThreads; ++i) {
+        std::atomic<std::uint64_t>& victim = m_ranges[(worker + i) % m_numThreads].bounds;
+        std::uint64_t current = victim.load();
+        while (true)
+        {
+            const std::uint32_t begin = static_cast<std::uint32_t>(current >> 32);
+            const std::uint32_t end = static_cast<std::uint32_t>(current);
+            if (begin >= end)
+                break;
+            // the back half, or the last item
+            const std::uint32_t middle = begin + (end - begin) / 2;
+            if (victim.compare_exchange_weak(current, pack(begin, middle)))
+            {
+                // the own range is empty, nobody else changes it
+                m_ranges[worker].bounds.store(pack(middle + 1, end));
+                *item = static_cast<int>(middle);
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,97 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+// Std
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Threads running loops over independent items, balanced by work stealing.
+ *
+ * Each thread starts with a contiguous range of the items and takes them
+ * one by one from its front. A thread done with its range steals the back
+ * half of the range of another one, so items of uneven cost keep all threads
+ * busy. Ranges are single atomic words on their own cache line: taking an
+ * item touches no state shared with other threads unless stealing.
+ *
+ * The threads are started once and wait between loops.
+ */
+class WorkStealingPool
+{
+public:
+    /**
+     * @param numThreads number of threads, including the one calling run(),
+     * 0 for all cores
+     */
+    explicit WorkStealingPool(int numThreads = 0);
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int threadCount() const { return m_numThreads; }
+    /**
+     * Calls body(worker, item) for every item in [0, count), on all threads,
+     * and returns once all calls returned. worker is in [0, threadCount()),
+     * calls with the same worker never run concurrently, so it can index
+     * per thread state. The calling thread is worker 0
+     */
+    void run(int count, const std::function<void(int worker, int item)>& body);
+
+private:
+    /**
+     * Items [begin, end) left to a thread, as begin << 32 | end
+     */
+    struct Range
+    {
+        std::atomic<std::uint64_t> bounds;
+        char padding[64 - sizeof(std::atomic<std::uint64_t>)];
+    };
+
+    static std::uint64_t pack(std::uint32_t begin, std::uint32_t end)
+    {
+        return static_cast<std::uint64_t>(begin) << 32 | end;
+    }
+    void threadMain(int worker);
+    void work(int worker, const std::function<void(int, int)>& body);
+    /**
+     * Takes the first item of the range of worker
+     */
+    bool takeFront(int worker, int* item);
+    /**
+     * Moves the back half of another range to the one of worker,
+     * taking its first item
+     */
+    bool steal(int worker, int* item);
+
+    int m_numThreads;
+    std::unique_ptr<Range[]> m_ranges;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_started;
+    std::condition_variable m_finished;
+    const std::function<void(int, int)>* m_body = nullptr;
+    /**
+     * Incremented by every run(), threads wait for the next one
+     */
+    int m_generation = 0;
+    /**
+     * Number of threads still working on the current run()
+     */
+    int m_running = 0;
+    bool m_stopping = false;
+};
+
+#endif
@@ -0,0 +1,379 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "externalaiserver.h"
+
+// own
+#include "kmines_debug.h"
+#include "minefielditem.h"
+// Qt
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QPointer>
+#include <QtEndian>
+
+const quint32 ExternalAiServer::MAX_FRAME_SIZE;
+
+namespace
+{
+
+/**
+ * Frames of a client handled before letting the event loop run
+ */
+const int MAX_FRAMES_PER_TURN = 64;
+/**
+ * Clients not reading what they are sent are disconnected past this
+ */
+const qint64 MAX_PENDING_WRITE = 64*1024*1024;
+/**
+ * Size of the length prefix of a frame
+ */
+const int HEADER_SIZE = 4;
+/**
+ * Size of a move in SubmitMoves and of a cell in Delta
+ */
+const int MOVE_SIZE = 5;
+
+/**
+ * Starts a frame of type in out, finished by endFrame()
+ */
+void beginFrame(QByteArray& out, quint8 type)
+{
+    out.resize(HEADER_SIZE);
+    out.append(static_cast<char>(type));
+}
+
+void endFrame(QByteArray& out)
+{
+    qToLittleEndian<quint32>(out.size() - HEADER_SIZE, out.data());
+}
+
+void appendU8(QByteArray& out, quint8 value)
+{
+    out.append(static_cast<char>(value));
+}
+
+void appendU16(QByteArray& out, quint16 value)
+{
+    const int pos = out.size();
+    out.resize(pos + 2);
+    qToLittleEndian<quint16>(value, out.data() + pos);
+}
+
+void appendU32(QByteArray& out, quint32 value)
+{
+    const int pos = out.size();
+    out.resize(pos + 4);
+    qToLittleEndian<quint32>(value, out.data() + pos);
+}
+
+}
+
+ExternalAiServer::ExternalAiServer(MineFieldItem* fieldItem, QObject* parent)
+    : QObject(parent), m_fieldItem(fieldItem), m_server(new QLocalServer(this))
+{
+    connect(m_server, &QLocalServer::newConnection, this, &ExternalAiServer::onNewConnection);
+    connect(m_fieldItem, &MineFieldItem::cellsChanged, this, &ExternalAiServer::onCellsChanged);
+    connect(m_fieldItem, &MineFieldItem::fieldReset, this, &ExternalAiServer::onFieldReset);
+    connect(m_fieldItem, &MineFieldItem::gameOver, this, &ExternalAiServer::onGameOver);
+    onFieldReset();
+}
+
+ExternalAiServer::~ExternalAiServer()
+{
+    // sockets are children of the server and go with it, without calling back
+    const QList<QLocalSocket*> sockets = m_clients.keys();
+    for(QLocalSocket* socket : sockets)
+        socket->disconnect(this);
+}
+
+bool ExternalAiServer::listen(const QString& name)
+{
+    if(m_server->listen(name))
+        return true;
+    if(m_server->serverError() != QAbstractSocket::AddressInUseError)
+        return false;
+
+    // a socket left by a crashed game, unless a running one answers
+    QLocalSocket probe;
+    probe.connectToServer(name);
+    if(probe.waitForConnected(100))
+        return false;
+    QLocalServer::removeServer(name);
+    return m_server->listen(name);
+}
+
+QString ExternalAiServer::errorString() const
+{
+    return m_server->errorString();
+}
+
+bool ExternalAiServer::playedThisGame() const
+{
+    return m_playedThisGame;
+}
+
+void ExternalAiServer::onNewConnection()
+{
+    while(QLocalSocket* socket = m_server->nextPendingConnection())
+    {
+        m_clients.insert(socket, std::make_shared<Client>());
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() { removeClient(socket); });
+        qCDebug(KMINES_LOG) << "external AI connected";
+        send(socket, snapshotFrame());
+    }
+}
+
+void ExternalAiServer::removeClient(QLocalSocket* socket)
+{
+    if(m_clients.remove(socket) == 0)
+        return;
+    qCDebug(KMINES_LOG) << "external AI disconnected";
+    socket->disconnect(this);
+    socket->abort();
+    socket->deleteLater();
+}
+
+void ExternalAiServer::onReadyRead(QLocalSocket* socket)
+{
+    const std::shared_ptr<Client> client = m_clients.value(socket);
+    if(!client)
+        return;
+    client->buffer.append(socket->readAll());
+    if(!client->processingQueued)
+        processFrames(socket);
+}
+
+void ExternalAiServer::processFrames(QLocalSocket* socket)
+{
+    // kept alive even if handling a frame drops the client
+    const std::shared_ptr<Client> client = m_clients.value(socket);
+    if(!client)
+        return;
+    client->processingQueued = false;
+
+    for(int frames = 0; frames < MAX_FRAMES_PER_TURN; ++frames)
+    {
+        const int available = client->buffer.size() - client->offset;
+        if(available < HEADER_SIZE)
+            break;
+        const quint32 length = qFromLittleEndian<quint32>(client->buffer.constData() + client->offset);
+        if(length == 0 || length > MAX_FRAME_SIZE)
+        {
+            qCWarning(KMINES_LOG) << "external AI sent a frame of invalid length" << length;
+            removeClient(socket);
+            return;
+        }
+        if(static_cast<quint32>(available - HEADER_SIZE) < length)
+            break;
+
+        // a copy, moves played may let more data in
+        const QByteArray frame = client->buffer.mid(client->offset + HEADER_SIZE, length);
+        client->offset += HEADER_SIZE + length;
+        if(!handleFrame(socket, frame))
+        {
+            qCWarning(KMINES_LOG) << "external AI sent a malformed frame of type" << quint8(frame.at(0));
+            removeClient(socket);
+            return;
+        }
+        if(!m_clients.contains(socket))
+            return;
+    }
+
+    client->buffer.remove(0, client->offset);
+    client->offset = 0;
+    // the rest waits for painting and input to be handled
+    if(client->buffer.size() >= HEADER_SIZE)
+    {
+        client->processingQueued = true;
+        QPointer<QLocalSocket> guard(socket);
+        QMetaObject::invokeMethod(this, [this, guard]() {
+            if(guard)
+                processFrames(guard);
+        }, Qt::QueuedConnection);
+    }
+}
+
+bool ExternalAiServer::handleFrame(QLocalSocket* socket, const QByteArray& frame)
+{
+    const uchar* payload = reinterpret_cast<const uchar*>(frame.constData()) + 1;
+    const int payloadSize = frame.size() - 1;
+    switch(static_cast<quint8>(frame.at(0)))
+    {
+    case RequestSnapshot:
+        if(payloadSize != 0)
+            return false;
+        send(socket, snapshotFrame());
+        return true;
+    case SubmitMoves:
+    {
+        if(payloadSize < 4)
+            return false;
+        const quint32 count = qFromLittleEndian<quint32>(payload);
+        if(static_cast<quint64>(payloadSize - 4) != static_cast<quint64>(count) * MOVE_SIZE)
+            return false;
+        for(quint32 i = 0; i < count; ++i)
+            if(payload[4 + i*MOVE_SIZE] > MineFieldItem::Move::Chord)
+                return false;
+        playMoves(socket, payload + 4, static_cast<int>(count));
+        return true;
+    }
+    case NewGame:
+        if(payloadSize != 0)
+            return false;
+        Q_EMIT newGameRequested();
+        return true;
+    default:
+        return false;
+    }
+}
+
+void ExternalAiServer::playMoves(QLocalSocket* socket, const uchar* data, int count)
+{
+    QVector<MineFieldItem::Move> moves(count);
+    for(int i = 0; i < count; ++i)
+    {
+        const uchar* move = data + i*MOVE_SIZE;
+        moves[i].type = static_cast<MineFieldItem::Move::Type>(move[0]);
+        // indexes out of the field are skipped by MineFieldItem::playMoves()
+        moves[i].idx = static_cast<int>(qMin<quint32>(qFromLittleEndian<quint32>(move + 1), 0x7fffffff));
+    }
+
+    // set before playing, game over handlers may ask for it
+    if(count > 0)
+        m_playedThisGame = true;
+    m_playing = true;
+    const int played = m_fieldItem->playMoves(moves);
+    m_playing = false;
+    flushDelta();
+
+    QByteArray frame;
+    beginFrame(frame, MovesApplied);
+    appendU32(frame, played);
+    appendU8(frame, status());
+    endFrame(frame);
+    send(socket, frame);
+}
+
+void ExternalAiServer::onCellsChanged(const std::vector<int>& cells)
+{
+    if(m_clients.isEmpty())
+        return;
+    for(int idx : cells)
+    {
+        if(!m_isChanged[idx])
+        {
+            m_isChanged[idx] = true;
+            m_changed.push_back(idx);
+        }
+    }
+    // moves of the player are sent once their signals are handled
+    if(!m_playing && !m_flushQueued)
+    {
+        m_flushQueued = true;
+        QMetaObject::invokeMethod(this, &ExternalAiServer::flushDelta, Qt::QueuedConnection);
+    }
+}
+
+void ExternalAiServer::onFieldReset()
+{
+    m_changed.clear();
+    m_isChanged.assign(m_fieldItem->field().cellCount(), false);
+    m_playedThisGame = false;
+    m_status = Playing;
+    if(m_clients.isEmpty())
+        return;
+
+    const QByteArray frame = snapshotFrame();
+    const QList<QLocalSocket*> sockets = m_clients.keys();
+    for(QLocalSocket* socket : sockets)
+        send(socket, frame);
+}
+
+void ExternalAiServer::onGameOver(bool won)
+{
+    m_status = won ? Won : Lost;
+}
+
+void ExternalAiServer::flushDelta()
+{
+    m_flushQueued = false;
+    if(m_changed.empty())
+        return;
+
+    QByteArray frame;
+    frame.reserve(HEADER_SIZE + 6 + static_cast<int>(m_changed.size()) * MOVE_SIZE);
+    beginFrame(frame, Delta);
+    appendU8(frame, status());
+    appendU32(frame, static_cast<quint32>(m_changed.size()));
+    for(int idx : m_changed)
+    {
+        appendU32(frame, idx);
+        appendU8(frame, cellCode(idx));
+        m_isChanged[idx] = false;
+    }
+    endFrame(frame);
+    m_changed.clear();
+
+    const QList<QLocalSocket*> sockets = m_clients.keys();
+    for(QLocalSocket* socket : sockets)
+        send(socket, frame);
+}
+
+quint8 ExternalAiServer::status() const
+{
+    if(m_status == Playing && !m_fieldItem->isVisible())
+        return Paused;
+    return m_status;
+}
+
+quint8 ExternalAiServer::cellCode(int idx) const
+{
+    const MineField& field = m_fieldItem->field();
+    switch(field.state(idx))
+    {
+    case KMinesState::Revealed:
+        if(field.hasMine(idx))
+            return field.isExploded(idx) ? ExplodedMine : Mine;
+        return static_cast<quint8>(field.digit(idx));
+    case KMinesState::Flagged:
+        return Flagged;
+    case KMinesState::Questioned:
+        return Questioned;
+    case KMinesState::Error:
+        return WrongFlag;
+    default:
+        return Unrevealed;
+    }
+}
+
+QByteArray ExternalAiServer::snapshotFrame() const
+{
+    const MineField& field = m_fieldItem->field();
+    QByteArray frame;
+    frame.reserve(HEADER_SIZE + 10 + field.cellCount());
+    beginFrame(frame, Snapshot);
+    appendU16(frame, field.rowCount());
+    appendU16(frame, field.columnCount());
+    appendU32(frame, field.minesCount());
+    appendU8(frame, status());
+    for(int idx = 0; idx < field.cellCount(); ++idx)
+        appendU8(frame, cellCode(idx));
+    endFrame(frame);
+    return frame;
+}
+
+void ExternalAiServer::send(QLocalSocket* socket, const QByteArray& frame)
+{
+    if(socket->bytesToWrite() > MAX_PENDING_WRITE)
+    {
+        qCWarning(KMINES_LOG) << "external AI doesn't read what it is sent, disconnecting it";
+        removeClient(socket);
+        return;
+    }
+    socket->write(frame);
+}
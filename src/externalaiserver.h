@@ -0,0 +1,138 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef EXTERNALAISERVER_H
+#define EXTERNALAISERVER_H
+
+// Qt
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+// Std
+#include <memory>
+#include <vector>
+
+class MineFieldItem;
+class QLocalServer;
+class QLocalSocket;
+
+/**
+ * Lets external AI programs play the current game through a local socket.
+ *
+ * Messages are binary frames: a 32 bit length, then a type byte and its
+ * payload, the length counting both. All integers are little endian.
+ *
+ * Client messages:
+ * @li RequestSnapshot, no payload
+ * @li SubmitMoves: u32 count, then count times u8 action (0 reveal,
+ *     1 toggle flag, 2 chord) and u32 cell index (row*columns + column).
+ *     They are played at once as a single move, see MineFieldItem::playMoves()
+ * @li NewGame, no payload: starts a new game of the current level
+ *
+ * Server messages:
+ * @li Snapshot: u16 rows, u16 columns, u32 mines, u8 status, then a cell
+ *     code per cell. Sent on connection, on request and when all cells
+ *     are released again, for a new game or a reset
+ * @li Delta: u8 status, u32 count, then count times u32 cell index and
+ *     u8 cell code. Sent after each move, by the player or any client,
+ *     with the cells it changed
+ * @li MovesApplied: u32 number of moves played, u8 status. Answers
+ *     SubmitMoves, after the Delta of these moves
+ *
+ * Cell codes are 0-8 for revealed digits, then those of CellCode.
+ * Mines are only told once revealed, when the game is over.
+ * Clients sending malformed frames are disconnected.
+ *
+ * Frames are handled in batches, so a client flooding the socket
+ * doesn't keep the game from painting and handling input
+ */
+class ExternalAiServer : public QObject
+{
+    Q_OBJECT
+public:
+    enum MessageType : quint8 {
+        RequestSnapshot = 0x01, SubmitMoves = 0x02, NewGame = 0x03,
+        Snapshot = 0x81, Delta = 0x82, MovesApplied = 0x83
+    };
+    enum Status : quint8 { Playing, Won, Lost, Paused };
+    enum CellCode : quint8 { Unrevealed = 9, Flagged, Questioned, Mine, ExplodedMine, WrongFlag };
+    /**
+     * Largest frame length accepted, about three million moves
+     */
+    static const quint32 MAX_FRAME_SIZE = 16*1024*1024;
+
+    ExternalAiServer(MineFieldItem* fieldItem, QObject* parent);
+    ~ExternalAiServer() override;
+    /**
+     * Starts listening on the local socket called name
+     *
+     * @return whether it succeeded, see errorString() otherwise
+     */
+    bool listen(const QString& name);
+    QString errorString() const;
+    /**
+     * @return whether a client played moves in the current game
+     */
+    bool playedThisGame() const;
+
+Q_SIGNALS:
+    void newGameRequested();
+private:
+    struct Client
+    {
+        QByteArray buffer;
+        /**
+         * Start of the first frame not handled yet in buffer
+         */
+        int offset = 0;
+        bool processingQueued = false;
+    };
+
+    void onNewConnection();
+    void onReadyRead(QLocalSocket* socket);
+    void removeClient(QLocalSocket* socket);
+    /**
+     * Handles a batch of complete frames received from socket,
+     * queueing the rest for the next event loop iteration
+     */
+    void processFrames(QLocalSocket* socket);
+    /**
+     * @return false if the frame is malformed
+     */
+    bool handleFrame(QLocalSocket* socket, const QByteArray& frame);
+    void playMoves(QLocalSocket* socket, const uchar* data, int count);
+
+    void onCellsChanged(const std::vector<int>& cells);
+    void onFieldReset();
+    void onGameOver(bool won);
+    /**
+     * Sends cells changed since the last call to all clients
+     */
+    void flushDelta();
+
+    quint8 status() const;
+    quint8 cellCode(int idx) const;
+    QByteArray snapshotFrame() const;
+    void send(QLocalSocket* socket, const QByteArray& frame);
+
+    MineFieldItem* m_fieldItem;
+    QLocalServer* m_server;
+    QHash<QLocalSocket*, std::shared_ptr<Client> > m_clients;
+    /**
+     * Cells changed since the last Delta, without duplicates
+     */
+    std::vector<int> m_changed;
+    std::vector<bool> m_isChanged;
+    bool m_flushQueued = false;
+    /**
+     * Whether changes are sent by the move being played, not later
+     */
+    bool m_playing = false;
+    bool m_playedThisGame = false;
+    Status m_status = Playing;
+};
+
+#endif
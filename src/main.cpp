@@ -16,6 +16,7 @@
 #include <KSharedConfig>
 // Qt
 #include <QApplication>
+#include <QCommandLineOption>
 #include <QCommandLineParser>
 
 
@@ -62,14 +63,46 @@ int main(int argc, char **argv)
     KCrash::initialize();
     QCommandLineParser parser;
     aboutData.setupCommandLine(&parser);
+    const QCommandLineOption seedOption(QStringLiteral("seed"),
+                                        i18n("Generate fields from <seed>: the same first click gives the same field."),
+                                        i18nc("command line value", "seed"));
+    parser.addOption(seedOption);
+    const QCommandLineOption aiSocketOption(QStringLiteral("ai-socket"),
+                                            i18n("Let external AI programs play through the local socket <name>."),
+                                            i18nc("command line value", "name"));
+    parser.addOption(aiSocketOption);
     parser.process(app);
     aboutData.processCommandLine(&parser);
+
+    bool seeded = false;
+    quint64 seed = 0;
+    if ( parser.isSet(seedOption) )
+    {
+        seed = parser.value(seedOption).toULongLong(&seeded);
+        if ( !seeded )
+        {
+            qCritical("%s", qPrintable(i18n("Invalid seed: %1", parser.value(seedOption))));
+            return 1;
+        }
+    }
     KDBusService service; 
     
     if ( app.isSessionRestored() )
         kRestoreMainWindows<KMinesMainWindow>();
     else {
         KMinesMainWindow *mw = new KMinesMainWindow;
+        if ( seeded )
+            mw->setSeed(seed);
+        if ( parser.isSet(aiSocketOption) )
+        {
+            QString error;
+            if ( !mw->startAiServer(parser.value(aiSocketOption), &error) )
+            {
+                qCritical("%s", qPrintable(i18n("Cannot listen on socket %1: %2", parser.value(aiSocketOption), error)));
+                delete mw;
+                return 1;
+            }
+        }
         mw->show();
     }
     
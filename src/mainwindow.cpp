@@ -8,6 +8,7 @@
 #include "mainwindow.h"
 
 // own
+#include "externalaiserver.h"
 #include "minefielditem.h"
 #include "scene.h"
 #include "settings.h"
@@ -24,12 +25,56 @@
 #include <KActionCollection>
 #include <KConfigDialog>
 #include <KLocalizedString>
+#include <KToggleAction>
 // Qt
 #include <QScreen>
 #include <QStatusBar>
 #include <QDesktopWidget>
 #include <QMessageBox>
 
+namespace
+{
+
+struct LevelSize
+{
+    int rows;
+    int cols;
+    int mines;
+};
+
+/**
+ * Size of a standard level, no guessing levels are played on the same sizes
+ */
+LevelSize standardLevelSize(KgDifficultyLevel::StandardLevel level)
+{
+    switch(level)
+    {
+        case KgDifficultyLevel::Medium:
+            return { 16, 16, 40 };
+        case KgDifficultyLevel::Hard:
+            return { 16, 30, 99 };
+        default:
+            return { 9, 9, 10 };
+    }
+}
+
+/**
+ * @return the standard level a no guessing level is played like,
+ * by its key, or NoStandardLevel for other keys
+ */
+KgDifficultyLevel::StandardLevel noGuessBaseLevel(const QByteArray& key)
+{
+    if(key == "NoGuessEasy")
+        return KgDifficultyLevel::Easy;
+    if(key == "NoGuessMedium")
+        return KgDifficultyLevel::Medium;
+    if(key == "NoGuessHard")
+        return KgDifficultyLevel::Hard;
+    return KgDifficultyLevel::NoStandardLevel;
+}
+
+}
+
 /*
  * Classes for config dlg pages
  */
@@ -88,8 +133,9 @@ KMinesMainWindow::KMinesMainWindow()
 
     m_view = new KMinesView( m_scene, this );
     m_view->setCacheMode( QGraphicsView::CacheBackground );
-    m_view->setVerticalScrollBarPolicy( Qt::ScrollBarAlwaysOff );
-    m_view->setHorizontalScrollBarPolicy( Qt::ScrollBarAlwaysOff );
+    // only very large custom fields don't fit in the view
+    m_view->setVerticalScrollBarPolicy( Qt::ScrollBarAsNeeded );
+    m_view->setHorizontalScrollBarPolicy( Qt::ScrollBarAsNeeded );
     m_view->setFrameStyle(QFrame::NoFrame);
 
     m_view->setOptimizationFlags( 
@@ -119,10 +165,27 @@ void KMinesMainWindow::setupActions()
     KStandardGameAction::quit(this, &KMinesMainWindow::close, actionCollection());
     KStandardAction::preferences(this, &KMinesMainWindow::configureSettings, actionCollection());
     m_actionPause = KStandardGameAction::pause(this, &KMinesMainWindow::pauseGame, actionCollection());
+    m_actionHint = KStandardGameAction::hint(this, &KMinesMainWindow::showHint, actionCollection());
+
+    KToggleAction* showProbabilities = actionCollection()->add<KToggleAction>(QStringLiteral("show_probabilities"));
+    showProbabilities->setText(i18n("Show Mine &Probabilities"));
+    showProbabilities->setChecked(Settings::showMineProbabilities());
+    connect(showProbabilities, &KToggleAction::toggled, this, &KMinesMainWindow::showProbabilities);
+    m_scene->setShowProbabilities(Settings::showMineProbabilities());
 
     Kg::difficulty()->addStandardLevelRange(
         KgDifficultyLevel::Easy, KgDifficultyLevel::Hard
     );
+    // same sizes as the standard levels, placed right after each of them
+    Kg::difficulty()->addLevel(new KgDifficultyLevel(KgDifficultyLevel::Easy + 1,
+        QByteArray( "NoGuessEasy" ), i18n( "Easy, No Guessing" )
+    ));
+    Kg::difficulty()->addLevel(new KgDifficultyLevel(KgDifficultyLevel::Medium + 1,
+        QByteArray( "NoGuessMedium" ), i18n( "Medium, No Guessing" )
+    ));
+    Kg::difficulty()->addLevel(new KgDifficultyLevel(KgDifficultyLevel::Hard + 1,
+        QByteArray( "NoGuessHard" ), i18n( "Hard, No Guessing" )
+    ));
     Kg::difficulty()->addLevel(new KgDifficultyLevel(1000,
         QByteArray( "Custom" ), i18n( "Custom" )
     ));
@@ -136,6 +199,23 @@ void KMinesMainWindow::setupActions()
 #endif
 }
 
+void KMinesMainWindow::setSeed(quint64 seed)
+{
+    m_scene->setSeed(seed);
+}
+
+bool KMinesMainWindow::startAiServer(const QString& name, QString* errorString)
+{
+    m_aiServer = new ExternalAiServer(m_scene->fieldItem(), this);
+    connect(m_aiServer, &ExternalAiServer::newGameRequested, this, &KMinesMainWindow::newGame);
+    if(m_aiServer->listen(name))
+        return true;
+    *errorString = m_aiServer->errorString();
+    delete m_aiServer;
+    m_aiServer = nullptr;
+    return false;
+}
+
 void KMinesMainWindow::onMinesCountChanged(int count)
 {
     mineLabel->setText(i18n("Mines: %1/%2", count, m_scene->totalMines()));
@@ -154,23 +234,37 @@ void KMinesMainWindow::newGame()
             m_actionPause->setChecked(false);
     }
     m_actionPause->setEnabled(false);
+    m_actionHint->setEnabled(false);
 
     Kg::difficulty()->setGameRunning(false);
-    switch(Kg::difficultyLevel())
+    KgDifficultyLevel::StandardLevel level = Kg::difficultyLevel();
+    bool noGuess = false;
+    if(level == KgDifficultyLevel::Custom)
+    {
+        // no guessing levels are custom levels too, tell them by key
+        const KgDifficultyLevel::StandardLevel base = noGuessBaseLevel(Kg::difficulty()->currentLevel()->key());
+        if(base != KgDifficultyLevel::NoStandardLevel)
+        {
+            level = base;
+            noGuess = true;
+        }
+    }
+    switch(level)
     {
         case KgDifficultyLevel::Easy:
-            m_scene->startNewGame(9, 9, 10);
-            break;
         case KgDifficultyLevel::Medium:
-            m_scene->startNewGame(16,16,40);
-            break;
         case KgDifficultyLevel::Hard:
-            m_scene->startNewGame(16,30,99);
+        {
+            const LevelSize size = standardLevelSize(level);
+            m_scene->startNewGame(size.rows, size.cols, size.mines, noGuess);
             break;
+        }
         case KgDifficultyLevel::Custom:
             m_scene->startNewGame(Settings::customHeight(),
                                   Settings::customWidth(),
-                                  Settings::customMines());
+                                  Settings::customMines(),
+                                  Settings::customNoGuess());
+            break;
         default:
             //unsupported
             break;
@@ -183,7 +277,11 @@ void KMinesMainWindow::onGameOver(bool won)
 {
     m_gameClock->pause();
     m_actionPause->setEnabled(false);
+    m_actionHint->setEnabled(false);
     Kg::difficulty()->setGameRunning(false);
+    // no scores nor questions, games played by a program follow each other
+    if(m_aiServer && m_aiServer->playedThisGame())
+        return;
     if(won && m_scene->canScore())
     {
         QPointer<KScoreDialog> scoreDialog = new KScoreDialog(KScoreDialog::Name | KScoreDialog::Time, this);
@@ -208,6 +306,7 @@ void KMinesMainWindow::onGameOver(bool won)
             m_scene->reset();
             m_gameClock->restart();
             m_actionPause->setEnabled(true);
+            m_actionHint->setEnabled(true);
             m_scene->setCanScore(!Settings::disableScoreOnReset());
         }
     }
@@ -220,8 +319,9 @@ void KMinesMainWindow::advanceTime(const QString& timeStr)
 
 void KMinesMainWindow::onFirstClick()
 {
-    // enable pause action
+    // enable pause and hint actions
     m_actionPause->setEnabled(true);
+    m_actionHint->setEnabled(true);
     // start clock
     m_gameClock->resume();
     Kg::difficulty()->setGameRunning(true);
@@ -253,6 +353,7 @@ void KMinesMainWindow::configureSettings()
 void KMinesMainWindow::pauseGame(bool paused)
 {
     m_scene->setGamePaused( paused );
+    m_actionHint->setEnabled( !paused );
     if( paused )
         m_gameClock->pause();
     else
@@ -263,8 +364,20 @@ void KMinesMainWindow::loadSettings()
 {
     m_view->resetCachedContent();
     // trigger complete redraw
-    m_scene->resizeScene( (int)m_scene->sceneRect().width(),
-                          (int)m_scene->sceneRect().height() );
+    m_scene->resizeScene( m_view->viewport()->width(),
+                          m_view->viewport()->height() );
+}
+
+void KMinesMainWindow::showProbabilities(bool show)
+{
+    Settings::setShowMineProbabilities(show);
+    Settings::self()->save();
+    m_scene->setShowProbabilities(show);
+}
+
+void KMinesMainWindow::showHint()
+{
+    m_scene->showHint();
 }
 
 #include "mainwindow.moc"
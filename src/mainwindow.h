@@ -13,16 +13,29 @@
 #include <QPointer>
 #include <QLabel>
 
+class ExternalAiServer;
 class KMinesScene;
 class KMinesView;
 class KGameClock;
 class KToggleAction;
+class QAction;
 
 class KMinesMainWindow : public KXmlGuiWindow
 {
     Q_OBJECT
 public:
     KMinesMainWindow();
+    /**
+     * Generates fields from seed, so the same first click gives the same field
+     */
+    void setSeed(quint64 seed);
+    /**
+     * Lets external AI programs play through the local socket called name,
+     * see ExternalAiServer
+     *
+     * @return whether it listens, errorString tells why not otherwise
+     */
+    bool startAiServer(const QString& name, QString* errorString);
 private Q_SLOTS:
     void onMinesCountChanged(int count);
     void newGame();
@@ -33,12 +46,16 @@ private Q_SLOTS:
     void configureSettings();
     void pauseGame(bool paused);
     void loadSettings();
+    void showProbabilities(bool show);
+    void showHint();
 private:
     void setupActions();
     KMinesScene* m_scene = nullptr;
     KMinesView* m_view = nullptr;
     KGameClock* m_gameClock = nullptr;
     KToggleAction* m_actionPause = nullptr;
+    QAction* m_actionHint = nullptr;
+    ExternalAiServer* m_aiServer = nullptr;
     
     QPointer<QLabel> mineLabel = new QLabel;
     QPointer<QLabel> timeLabel = new QLabel;
@@ -9,220 +9,129 @@
 
 // own
 #include "kmines_debug.h"
-#include "cellitem.h"
-#include "borderitem.h"
+#include "boarditem.h"
+#include "mineprobability.h"
+#include "noguessgenerator.h"
+#include "probabilityitem.h"
 #include "settings.h"
 // Qt
 #include <QGraphicsScene>
 #include <QGraphicsSceneMouseEvent>
 #include <QRandomGenerator>
+#include <QRunnable>
+// Std
+#include <atomic>
+#include <functional>
 
-MineFieldItem::MineFieldItem(KGameRenderer* renderer)
-    : m_leftButtonPos(-1,-1), m_midButtonPos(-1,-1), m_gameOver(false),
-      m_emulatingMidButton(false), m_renderer(renderer)
-{
-	setFlag(QGraphicsItem::ItemHasNoContents);
-}
-
-void MineFieldItem::resetMines()
+namespace
 {
-    m_gameOver = false;
-    m_numUnrevealed = m_numRows*m_numCols;
 
-    for(CellItem* item : qAsConst(m_cells)) {
-        item->unreveal();
-        item->unflag();
-        item->unexplode();
-    }
-
-    m_flaggedMinesCount = 0;
-    Q_EMIT flaggedMinesCountChanged(m_flaggedMinesCount);
-}
-
-
-void MineFieldItem::initField( int numRows, int numCols, int numMines )
+/**
+ * Runs a function in a thread pool, like QRunnable::create() of Qt 5.15
+ */
+class FunctionTask : public QRunnable
 {
-    numMines = qMin(numMines, numRows*numCols - MINIMAL_FREE );
-
-    m_firstClick = true;
-    m_gameOver = false;
-
-    int oldSize = m_cells.size();
-    int newSize = numRows*numCols;
-    int oldBorderSize = m_borders.size();
-    int newBorderSize = (numCols+2)*2 + (numRows+2)*2-4;
-
-    // if field is being shrunk, delete elements at the end before resizing vector
-    if(oldSize > newSize)
+public:
+    explicit FunctionTask(std::function<void()> function)
+        : m_function(std::move(function))
     {
-        for( int i=newSize; i<oldSize; ++i )
-        {
-            // is this the best way to remove an item?
-            scene()->removeItem(m_cells[i]);
-            delete m_cells[i];
-        }
-
-        // adjust border item array too
-        for( int i=newBorderSize; i<oldBorderSize; ++i)
-        {
-            scene()->removeItem(m_borders[i]);
-            delete m_borders[i];
-        }
     }
-
-    m_cells.resize(newSize);
-    m_borders.resize(newBorderSize);
-
-    m_numRows = numRows;
-    m_numCols = numCols;
-    m_minesCount = numMines;
-    m_numUnrevealed = m_numRows*m_numCols;
-    m_midButtonPos = qMakePair(-1, -1);
-    m_leftButtonPos = qMakePair(-1, -1);
-
-    for(int i=0; i<newSize; ++i)
+    void run() override
     {
-        // reset old, create new
-        if(i<oldSize)
-            m_cells[i]->reset();
-        else
-            m_cells[i] = new CellItem(m_renderer, this);
-        // let it be empty by default
-        // generateField() will adjust needed cells
-        // to hold digits or mines
-        m_cells[i]->setDigit(0);
+        m_function();
     }
+private:
+    std::function<void()> m_function;
+};
 
-    for(int i=oldBorderSize; i<newBorderSize; ++i)
-            m_borders[i] = new BorderItem(m_renderer, this);
+}
 
-    setupBorderItems();
+struct MineFieldItem::ProbabilityJob
+{
+    MineProbability probabilities;
+    std::atomic<bool> cancelled{false};
+};
 
-    adjustItemPositions();
-    m_flaggedMinesCount = 0;
-    Q_EMIT flaggedMinesCountChanged(m_flaggedMinesCount);
+MineFieldItem::MineFieldItem(KGameRenderer* renderer)
+    : m_atlas(renderer), m_leftButtonPos(-1,-1), m_midButtonPos(-1,-1),
+      m_emulatingMidButton(false), m_boardQueue(QRandomGenerator::global()->generate64())
+{
+	setFlag(QGraphicsItem::ItemHasNoContents);
+    m_boardItem = new BoardItem(&m_atlas, &m_field, this);
+    m_probabilityItem = new ProbabilityItem(&m_field, this);
+    m_probabilityItem->setVisible(false);
+    m_probabilityPool.setMaxThreadCount(1);
 }
 
-void MineFieldItem::generateField(int clickedIdx)
+MineFieldItem::~MineFieldItem()
 {
-    // generating mines ensuring that clickedIdx won't hold mine
-    // and that it will be an empty cell so the user don't have
-    // to make random guesses at the start of the game
-    QList<int> cellsWithMines;
-    int minesToPlace = m_minesCount;
-    int randomIdx = 0;
-    CellItem* item = nullptr;
-    FieldPos fp = rowColFromIndex(clickedIdx);
+    // running computations refer to this item to deliver their result
+    cancelProbabilities();
+    m_probabilityPool.waitForDone();
+}
 
-    // this is the list of items we don't want to put the mine in
-    // to ensure that clickedIdx will stay an empty cell
-    // (it will be empty if none of surrounding items holds mine)
-    QList<CellItem*> neighbForClicked = adjacentItemsFor(fp.first, fp.second);
+void MineFieldItem::resetMines()
+{
+    m_field.reset();
+    m_field.clearChanges();
+    resetSolver();
+    requestProbabilities();
 
-    QRandomGenerator random(QRandomGenerator::global()->generate());
-    while(minesToPlace != 0)
-    {
-        randomIdx = random.bounded( m_numRows*m_numCols );
-        item = m_cells.at(randomIdx);
-        if(!item->hasMine()
-           && neighbForClicked.indexOf(item) == -1
-           && randomIdx != clickedIdx)
-        {
-            // ok, let's mine this place! :-)
-            item->setHasMine(true);
-            cellsWithMines.append(randomIdx);
-            minesToPlace--;
-        }
-        else
-            continue;
-    }
+    m_boardItem->reset();
 
-    for (int idx : qAsConst(cellsWithMines)) {
-        FieldPos rc = rowColFromIndex(idx);
-        const QList<CellItem*> neighbours = adjacentItemsFor(rc.first, rc.second);
-        for (CellItem *item : neighbours) {
-            if(!item->hasMine())
-                item->setDigit( item->digit()+1 );
-        }
-    }
+    Q_EMIT fieldReset();
+    Q_EMIT flaggedMinesCountChanged(m_field.flaggedCount());
 }
 
-void MineFieldItem::setupBorderItems()
+
+void MineFieldItem::initField( int numRows, int numCols, int numMines, bool noGuess )
 {
-    int i = 0;
-    for(int row=0; row<m_numRows+2; ++row)
-        for(int col=0; col<m_numCols+2; ++col)
-        {
-            if( row == 0 && col == 0)
-            {
-                m_borders.at(i)->setRowCol(0,0);
-                m_borders.at(i)->setBorderType(KMinesState::BorderCornerNW);
-                i++;
-            }
-            else if( row == 0 && col == m_numCols+1)
-            {
-                m_borders.at(i)->setRowCol(row,col);
-                m_borders.at(i)->setBorderType(KMinesState::BorderCornerNE);
-                i++;
-            }
-            else if( row == m_numRows+1 && col == 0 )
-            {
-                m_borders.at(i)->setRowCol(row,col);
-                m_borders.at(i)->setBorderType(KMinesState::BorderCornerSW);
-                i++;
-            }
-            else if( row == m_numRows+1 && col == m_numCols+1 )
-            {
-                m_borders.at(i)->setRowCol(row,col);
-                m_borders.at(i)->setBorderType(KMinesState::BorderCornerSE);
-                i++;
-            }
-            else if( row == 0 )
-            {
-                m_borders.at(i)->setRowCol(row,col);
-                m_borders.at(i)->setBorderType(KMinesState::BorderNorth);
-                i++;
-            }
-            else if( row == m_numRows+1 )
-            {
-                m_borders.at(i)->setRowCol(row,col);
-                m_borders.at(i)->setBorderType(KMinesState::BorderSouth);
-                i++;
-            }
-            else if( col == 0 )
-            {
-                m_borders.at(i)->setRowCol(row,col);
-                m_borders.at(i)->setBorderType(KMinesState::BorderWest);
-                i++;
-            }
-            else if( col == m_numCols+1 )
-            {
-                m_borders.at(i)->setRowCol(row,col);
-                m_borders.at(i)->setBorderType(KMinesState::BorderEast);
-                i++;
-            }
-        }
+    m_field.init(numRows, numCols, numMines);
+    m_noGuess = noGuess;
+    m_seed = m_seedFixed ? m_fixedSeed : QRandomGenerator::global()->generate64();
+    // searching a field solvable without guessing may take a while,
+    // the next ones are prepared in background. Random fields are quick.
+    // Prepared fields don't come from the fixed seed
+    if(noGuess && !m_seedFixed)
+        m_boardQueue.setFieldSize(numRows, numCols, numMines);
+    else
+        m_boardQueue.clear();
+    m_field.clearChanges();
+    resetSolver();
+
+    m_boardItem->reset();
+
+    m_midButtonPos = qMakePair(-1, -1);
+    m_leftButtonPos = qMakePair(-1, -1);
+
+    Q_EMIT fieldReset();
+    Q_EMIT flaggedMinesCountChanged(m_field.flaggedCount());
 }
 
 QRectF MineFieldItem::boundingRect() const
 {
     // +2 - because of border on each side
-    return QRectF(0, 0, m_cellSize*(m_numCols+2), m_cellSize*(m_numRows+2));
+    return QRectF(0, 0, m_cellSize*(m_field.columnCount()+2), m_cellSize*(m_field.rowCount()+2));
 }
 
 int MineFieldItem::rowCount() const
 {
-    return m_numRows;
+    return m_field.rowCount();
 }
 
 int MineFieldItem::columnCount() const
 {
-    return m_numCols;
+    return m_field.columnCount();
 }
 
 int MineFieldItem::minesCount() const
 {
-    return m_minesCount;
+    return m_field.minesCount();
+}
+
+const MineField& MineFieldItem::field() const
+{
+    return m_field;
 }
 
 void MineFieldItem::paint( QPainter * painter, const QStyleOptionGraphicsItem* opt, QWidget* w)
@@ -232,10 +141,8 @@ void MineFieldItem::paint( QPainter * painter, const QStyleOptionGraphicsItem* o
     Q_UNUSED(w);
 }
 
-void MineFieldItem::resizeToFitInRect(const QRectF& rect)
+int MineFieldItem::cellSizeFor(const QRectF& rect) const
 {
-    prepareGeometryChange();
-
     // +2 in some places - because of border on each side
 
     // here follows "cooomplex" algorithm to choose which side to
@@ -245,136 +152,114 @@ void MineFieldItem::resizeToFitInRect(const QRectF& rect)
     // to understand that criteria for choosing one side or another (for
     // determining cell size from it) is comparing
     // cols/r.width() and rows/r.height():
-    bool chooseHorizontalSide = (m_numCols+2) / rect.width() > (m_numRows+2) / rect.height();
+    const int numRows = m_field.rowCount();
+    const int numCols = m_field.columnCount();
+    bool chooseHorizontalSide = (numCols+2) / rect.width() > (numRows+2) / rect.height();
 
     qreal size = 0;
     if( chooseHorizontalSide )
-        size = rect.width() / (m_numCols+2);
+        size = rect.width() / (numCols+2);
     else
-        size = rect.height() / (m_numRows+2);
-
-    m_cellSize = static_cast<int>(size);
+        size = rect.height() / (numRows+2);
 
-    for (CellItem* item : qAsConst(m_cells)) {
-        item->setRenderSize(QSize(m_cellSize, m_cellSize));
-    }
+    if(m_field.cellCount() > LARGE_FIELD_CELLS && size < MIN_LARGE_FIELD_CELL_SIZE)
+        return MIN_LARGE_FIELD_CELL_SIZE;
+    return static_cast<int>(size);
+}
 
-    for (BorderItem *item : qAsConst(m_borders)) {
-        item->setRenderSize(QSize(m_cellSize, m_cellSize));
-    }
+void MineFieldItem::resizeToFitInRect(const QRectF& rect)
+{
+    prepareGeometryChange();
 
-    adjustItemPositions();
+    m_cellSize = cellSizeFor(rect);
+    // every look of a cell is rendered once here,
+    // the board is then composed from these pixmaps
+    m_atlas.setCellSize(m_cellSize);
+    m_boardItem->setCellSize(m_cellSize);
+    m_probabilityItem->setCellSize(m_cellSize);
 }
 
-void MineFieldItem::adjustItemPositions()
+void MineFieldItem::finishMove(MineField::GameResult result, int idx)
 {
-    Q_ASSERT( m_cells.size() == m_numRows*m_numCols );
-
-    for(int row=0; row<m_numRows; ++row)
-        for(int col=0; col<m_numCols; ++col)
-        {
-            itemAt(row,col)->setPos((col+1)*m_cellSize, (row+1)*m_cellSize);
+    clearHint();
+    const bool finished = m_field.isGameOver();
+    if(!finished)
+        ensureSolver();
+    bool revealed = false;
+    // large openings ripple away from the cell of the move
+    m_boardItem->updateCells(m_field.changedCells(), idx);
+    for (int changed : m_field.changedCells()) {
+        if (!finished && m_field.isRevealed(changed)) {
+            m_solver.cellRevealed(changed);
+            revealed = true;
         }
-
-    for (BorderItem* item : qAsConst(m_borders)) {
-        item->setPos( item->col()*m_cellSize, item->row()*m_cellSize );
     }
-}
+    Q_EMIT cellsChanged(m_field.changedCells());
+    m_field.clearChanges();
 
-bool MineFieldItem::onItemRevealed(int row, int col)
-{
-    m_numUnrevealed--;
-    if(itemAt(row,col)->hasMine())
+    // marks don't change what the solver knows
+    if(finished)
+        cancelProbabilities();
+    else if(revealed)
     {
-        revealAllMines();
+        m_solver.update();
+        requestProbabilities();
     }
-    else if(itemAt(row,col)->digit() == 0) // empty cell
+
+    if(result == MineField::GameWon)
     {
-        revealEmptySpace(row,col);
+        // now all mines should be flagged, notify about this
+        Q_EMIT flaggedMinesCountChanged(m_field.flaggedCount());
+        Q_EMIT gameOver(true);
     }
-    // now let's check for possible win/loss
-    if(checkLost())
-        return true;
-    return checkWon();
-}
-
-void MineFieldItem::revealEmptySpace(int row, int col)
-{
-    // recursively reveal neighbour cells until we find cells with digit
-    const QList<FieldPos> list = adjacentRowColsFor(row,col);
-    CellItem *item = nullptr;
-
-    for (const FieldPos& pos : list) {
-        // first is row, second is col
-        item = itemAt(pos);
-        if(item->isRevealed() || item->isFlagged() || item->isQuestioned())
-            continue;
-        if(item->digit() == 0)
-        {
-            item->reveal();
-            m_numUnrevealed--;
-            revealEmptySpace(pos.first,pos.second);
-        }
-        else
-        {
-            item->reveal();
-            m_numUnrevealed--;
-        }
+    else if(result == MineField::GameLost)
+    {
+        Q_EMIT gameOver(false);
     }
 }
 
 void MineFieldItem::mousePressEvent( QGraphicsSceneMouseEvent *ev )
 {
-    if(m_gameOver)
+    if(m_field.isGameOver())
         return;
 
     int row = static_cast<int>(ev->pos().y()/m_cellSize)-1;
     int col = static_cast<int>(ev->pos().x()/m_cellSize)-1;
-    if( row <0 || row >= m_numRows || col < 0 || col >= m_numCols )
-        return;
-
-    CellItem* itemUnderMouse = itemAt(row,col);
-    if(!itemUnderMouse)
-    {
-        qCDebug(KMINES_LOG) << "unexpected - no item under mouse";
+    if( row <0 || row >= m_field.rowCount() || col < 0 || col >= m_field.columnCount() )
         return;
-    }
 
+    const int idx = m_field.index(row, col);
     bool useFastExplore = Settings::exploreWithLeftClickOnNumberCells();
-    m_emulatingMidButton = ( useFastExplore ? ( (ev->buttons() & Qt::LeftButton) && ( itemUnderMouse->isRevealed() ) ) : ( (ev->buttons() & Qt::LeftButton) && (ev->buttons() & Qt::RightButton) ) );
+    bool revealed = m_field.isRevealed(idx);
+    m_emulatingMidButton = ( useFastExplore ? ( (ev->buttons() & Qt::LeftButton) && revealed ) : ( (ev->buttons() & Qt::LeftButton) && (ev->buttons() & Qt::RightButton) ) );
     bool midButtonPressed = (ev->button() == Qt::MiddleButton || m_emulatingMidButton );
 
     if(midButtonPressed)
     {
         // in case we just started mid-button emulation (first LeftClick then added a RightClick)
         // undo press that was made by LeftClick. in other cases it won't hurt :)
-        itemUnderMouse->undoPress();
-
-        const QList<CellItem*> neighbours = adjacentItemsFor(row,col);
-        for (CellItem* item : neighbours) {
-            if(!item->isFlagged() && !item->isQuestioned() && !item->isRevealed())
-                item->press();
-            m_midButtonPos = qMakePair(row,col);
+        m_boardItem->undoPress(idx);
 
-            m_leftButtonPos = qMakePair(-1,-1); // reset it
-        }
+        pressNeighbours(row,col);
+        m_midButtonPos = qMakePair(row,col);
+        m_leftButtonPos = qMakePair(-1,-1); // reset it
     }
     else if(ev->button() == Qt::LeftButton)
     {
-        itemUnderMouse->press();
+        m_boardItem->press(idx);
         m_leftButtonPos = qMakePair(row,col);
     }
 }
 
 void MineFieldItem::mouseReleaseEvent( QGraphicsSceneMouseEvent * ev)
 {
-    if(m_gameOver)
+    if(m_field.isGameOver())
         return;
 
     int row = static_cast<int>(ev->pos().y()/m_cellSize)-1;
     int col = static_cast<int>(ev->pos().x()/m_cellSize)-1;
 
-    if( row <0 || row >= m_numRows || col < 0 || col >= m_numCols )
+    if( row <0 || row >= m_field.rowCount() || col < 0 || col >= m_field.columnCount() )
     {
         // there might be the case when player moved mouse outside game field
         // while holding mid button and released it outside the field
@@ -382,23 +267,20 @@ void MineFieldItem::mouseReleaseEvent( QGraphicsSceneMouseEvent * ev)
         // and return
         if(m_midButtonPos.first != -1)
         {
-            const QList<CellItem*> neighbours = adjacentItemsFor(m_midButtonPos.first,m_midButtonPos.second);
-            for (CellItem *item : neighbours) {
-                item->undoPress();
-            }
+            undoPressNeighbours(m_midButtonPos.first,m_midButtonPos.second);
             m_midButtonPos = qMakePair(-1,-1);
             m_emulatingMidButton = false;
         }
         // same with left button
         if(m_leftButtonPos.first != -1)
         {
-            itemAt(m_leftButtonPos)->undoPress();
+            m_boardItem->undoPress(m_field.index(m_leftButtonPos.first, m_leftButtonPos.second));
             m_leftButtonPos = qMakePair(-1,-1);
         }
         return;
     }
 
-    CellItem* itemUnderMouse = itemAt(row,col);
+    const int idx = m_field.index(row, col);
 
     bool midButtonReleased = (ev->button() == Qt::MiddleButton || m_emulatingMidButton);
 
@@ -406,51 +288,15 @@ void MineFieldItem::mouseReleaseEvent( QGraphicsSceneMouseEvent * ev)
     {
         m_midButtonPos = qMakePair(-1,-1);
 
-        const QList<CellItem*> neighbours = adjacentItemsFor(row,col);
-        if(!itemUnderMouse->isRevealed())
-        {
-            for (CellItem *item : neighbours) {
-                item->undoPress();
-            }
-            return;
-        }
-
-        int numFlags = 0;
-        int numMines = 0;
-        for (CellItem *item : neighbours) {
-            if(item->isFlagged())
-                numFlags++;
-            if(item->hasMine())
-                numMines++;
-        }
-        if(numFlags == numMines && numFlags != 0)
-        {
-            for (CellItem *item : neighbours) {
-                if(!item->isRevealed()) // revealing only unrevealed ones
-                {
-                    // force=true to omit Pressed check
-                    item->release(true);
-                    // If revealing the item ends the game, stop the loop,
-                    // since everything that needs to be done for the current game is finished.
-                    // Otherwise, if the user has restarted the game, we'll be revealing
-                    // items for the new game.
-                    if(item->isRevealed() && onItemRevealed(item))
-                        break;
-                }
-            }
-        }
-        else
-        {
-            for (CellItem *item : neighbours) {
-                item->undoPress();
-            }
-        }
+        undoPressNeighbours(row,col);
+        // revealing neighbours if flags around match the digit
+        finishMove(m_field.chord(idx), idx);
     }
     else if(ev->button() == Qt::LeftButton && (ev->buttons() & Qt::RightButton) == false)
     {
         if(m_midButtonPos.first != -1) // mid-button is already pressed
         {
-            itemUnderMouse->undoPress();
+            m_boardItem->undoPress(idx);
             return;
         }
 
@@ -460,48 +306,32 @@ void MineFieldItem::mouseReleaseEvent( QGraphicsSceneMouseEvent * ev)
         if(m_leftButtonPos.first == -1)
             return;
 
-        if(!itemUnderMouse->isRevealed()) // revealing only unrevealed ones
+        m_boardItem->undoPress(idx);
+        if(!m_field.isRevealed(idx)) // revealing only unrevealed ones
         {
-            if(m_firstClick)
-            {
-                m_firstClick = false;
-                generateField( row*m_numCols + col );
-                Q_EMIT firstClickDone();
-            }
-
-            itemUnderMouse->release();
-            if(itemUnderMouse->isRevealed())
-                onItemRevealed(row,col);
+            ensureGenerated(idx);
+            finishMove(m_field.reveal(idx), idx);
         }
         m_leftButtonPos = qMakePair(-1,-1);//reset
     }
     else if(ev->button() == Qt::RightButton && (ev->buttons() & Qt::LeftButton) == false)
     {
-        bool wasFlagged = itemUnderMouse->isFlagged();
-
-        itemUnderMouse->mark();
-
-        bool flagStateChanged = (itemUnderMouse->isFlagged() != wasFlagged);
+        bool flagStateChanged = m_field.mark(idx, Settings::useQuestionMarks());
+        finishMove(MineField::GameContinues, idx);
         if(flagStateChanged)
-        {
-            if(itemUnderMouse->isFlagged())
-                m_flaggedMinesCount++;
-            else
-                m_flaggedMinesCount--;
-            Q_EMIT flaggedMinesCountChanged(m_flaggedMinesCount);
-        }
+            Q_EMIT flaggedMinesCountChanged(m_field.flaggedCount());
     }
 }
 
 void MineFieldItem::mouseMoveEvent( QGraphicsSceneMouseEvent *ev )
 {
-    if(m_gameOver)
+    if(m_field.isGameOver())
         return;
 
     int row = static_cast<int>(ev->pos().y()/m_cellSize)-1;
     int col = static_cast<int>(ev->pos().x()/m_cellSize)-1;
 
-    if( row < 0 || row >= m_numRows || col < 0 || col >= m_numCols )
+    if( row < 0 || row >= m_field.rowCount() || col < 0 || col >= m_field.columnCount() )
         return;
 
     bool midButtonPressed = ((ev->buttons() & Qt::MiddleButton) ||
@@ -513,17 +343,10 @@ void MineFieldItem::mouseMoveEvent( QGraphicsSceneMouseEvent *ev )
            (m_midButtonPos.first != row || m_midButtonPos.second != col))
         {
             // un-press previously pressed cells
-            const QList<CellItem*> prevNeighbours = adjacentItemsFor(m_midButtonPos.first,
-                                                                     m_midButtonPos.second);
-            for (CellItem *item : prevNeighbours) {
-                   item->undoPress();
-            }
+            undoPressNeighbours(m_midButtonPos.first, m_midButtonPos.second);
 
             // and press current neighbours
-            const QList<CellItem*> neighbours = adjacentItemsFor(row,col);
-            for (CellItem *item : neighbours) {
-                item->press();
-            }
+            pressNeighbours(row,col);
 
             m_midButtonPos = qMakePair(row,col);
         }
@@ -533,107 +356,237 @@ void MineFieldItem::mouseMoveEvent( QGraphicsSceneMouseEvent *ev )
         if((m_leftButtonPos.first != -1 && m_leftButtonPos.second != -1) &&
            (m_leftButtonPos.first != row || m_leftButtonPos.second != col))
         {
-            itemAt(m_leftButtonPos)->undoPress();
-            itemAt(row,col)->press();
+            m_boardItem->undoPress(m_field.index(m_leftButtonPos.first, m_leftButtonPos.second));
+            m_boardItem->press(m_field.index(row, col));
             m_leftButtonPos = qMakePair(row,col);
         }
     }
 }
 
-void MineFieldItem::revealAllMines()
+void MineFieldItem::ensureGenerated(int idx)
 {
-    for (CellItem* item : qAsConst(m_cells)) {
-        if( (item->isFlagged() && !item->hasMine()) || (!item->isFlagged() && item->hasMine()) )
+    if(m_field.isGenerated())
+        return;
+    if(!m_noGuess)
+        m_field.generate(idx, m_seed);
+    // a prepared field if the click opens the same area as its start cell.
+    // A fixed seed must give the same field whatever the machine load
+    else if(!m_boardQueue.take(m_field, idx)
+            && !NoGuessGenerator::generate(m_field, idx, m_seed, m_seedFixed ? 0 : NoGuessGenerator::TIMEOUT_MS))
+        qCDebug(KMINES_LOG) << "no field solvable without guessing found, using a random one";
+    const MineField::Origin& origin = m_field.origin();
+    qCDebug(KMINES_LOG) << "field generated from seed" << origin.seed << "first click at" << origin.clickedIdx
+                        << "flipped" << origin.flippedHorizontally << origin.flippedVertically
+                        << "clicked at" << idx;
+    Q_EMIT firstClickDone();
+}
+
+int MineFieldItem::playMoves(const QVector<Move>& moves)
+{
+    // not while paused, the field is hidden then
+    if(!isVisible() || m_field.isGameOver())
+        return 0;
+
+    const int flagged = m_field.flaggedCount();
+    MineField::GameResult result = MineField::GameContinues;
+    int played = 0;
+    int lastIdx = -1;
+    for(const Move& move : moves)
+    {
+        if(result != MineField::GameContinues)
+            break;
+        if(move.idx < 0 || move.idx >= m_field.cellCount())
+            continue;
+        switch(move.type)
         {
-            item->reveal();
-            m_numUnrevealed--;
+        case Move::Reveal:
+            if(!m_field.isRevealed(move.idx))
+            {
+                ensureGenerated(move.idx);
+                result = m_field.reveal(move.idx);
+            }
+            break;
+        case Move::ToggleFlag:
+            // flags only, question marks are a reminder for humans
+            m_field.mark(move.idx, false);
+            break;
+        case Move::Chord:
+            result = m_field.chord(move.idx);
+            break;
         }
+        lastIdx = move.idx;
+        ++played;
     }
+
+    // all changes are shown as one move
+    if(lastIdx >= 0)
+        finishMove(result, lastIdx);
+    if(m_field.flaggedCount() != flagged && result != MineField::GameWon)
+        Q_EMIT flaggedMinesCountChanged(m_field.flaggedCount());
+    return played;
 }
 
-bool MineFieldItem::onItemRevealed(CellItem* item)
+void MineFieldItem::pressNeighbours(int row, int col)
 {
-    int idx = m_cells.indexOf(item);
-    if(idx == -1)
-    {
-        qCDebug(KMINES_LOG) << "really strange - item not found";
-        return false;
+    for (int idx : m_field.neighbours(m_field.index(row, col))) {
+        // only unmarked unrevealed cells get pressed
+        m_boardItem->press(idx);
     }
-
-    int row = idx / m_numCols;
-    int col = idx - row*m_numCols;
-    return onItemRevealed(row,col);
 }
 
-bool MineFieldItem::checkLost()
+void MineFieldItem::undoPressNeighbours(int row, int col)
 {
-    // for loss...
-    for (CellItem* item : qAsConst(m_cells)) {
-        if(item->isExploded())
-        {
-            m_gameOver = true;
-            Q_EMIT gameOver(false);
-            return true;
-        }
+    for (int idx : m_field.neighbours(m_field.index(row, col))) {
+        m_boardItem->undoPress(idx);
     }
-    return false;
 }
 
-bool MineFieldItem::checkWon()
+void MineFieldItem::setShowProbabilities(bool show)
+{
+    m_showProbabilities = show;
+    m_probabilityItem->setVisible(show);
+    if(!show)
+        m_probabilityItem->setProbabilities(nullptr);
+    else if(m_probabilities && !m_probabilityJob)
+        m_probabilityItem->setProbabilities(m_probabilities.get());
+    else
+        requestProbabilities();
+}
+
+double MineFieldItem::mineProbability(int row, int col) const
+{
+    if(!m_probabilities || m_probabilityJob)
+        return -1;
+    return m_probabilities->probability(m_field.index(row, col));
+}
+
+void MineFieldItem::showHint()
 {
-    // this also takes into account the trivial case when
-    // only some cells left unflagged and they
-    // all contain bombs. this counts as win
-    if(m_numUnrevealed == m_minesCount)
+    if(!m_field.isGenerated() || m_field.isGameOver())
+        return;
+
+    // the solver is kept up to date after every move,
+    // so a certainly safe cell is known right away
+    ensureSolver();
+    // marked cells are left to the player, even safe ones
+    const int safe = m_solver.unmarkedSafeCell();
+    if(safe >= 0)
     {
-        // mark not flagged cells (if any) with flags
-        for (CellItem* item : qAsConst(m_cells)) {
-            if( item->isQuestioned() )
-                item->mark();
-            if( !item->isRevealed() && !item->isFlagged() )
-                item->mark();
-        }
-        m_gameOver = true;
-        // now all mines should be flagged, notify about this
-        Q_EMIT flaggedMinesCountChanged(m_minesCount);
-        Q_EMIT gameOver(true);
-        return true;
+        setHint(safe);
+        return;
     }
-    return false;
-}
-
-QList<FieldPos> MineFieldItem::adjacentRowColsFor(int row, int col)
-{
-    QList<FieldPos> resultingList;
-    if(row != 0 && col != 0) // upper-left diagonal
-        resultingList.append( qMakePair(row-1,col-1) );
-    if(row != 0) // upper
-        resultingList.append(qMakePair(row-1, col));
-    if(row != 0 && col != m_numCols-1) // upper-right diagonal
-        resultingList.append(qMakePair(row-1, col+1));
-    if(col != 0) // on the left
-        resultingList.append(qMakePair(row,col-1));
-    if(col != m_numCols-1) // on the right
-        resultingList.append(qMakePair(row, col+1));
-    if(row != m_numRows-1 && col != 0) // bottom-left diagonal
-        resultingList.append(qMakePair(row+1, col-1));
-    if(row != m_numRows-1) // bottom
-        resultingList.append(qMakePair(row+1, col));
-    if(row != m_numRows-1 && col != m_numCols-1) // bottom-right diagonal
-        resultingList.append(qMakePair(row+1, col+1));
-    return resultingList;
-}
-
-QList<CellItem*> MineFieldItem::adjacentItemsFor(int row, int col)
-{
-    const QList<FieldPos > rowcolList = adjacentRowColsFor(row,col);
-    QList<CellItem*> resultingList;
-    for (const FieldPos& pos : rowcolList) {
-        resultingList.append( itemAt(pos) );
+
+    // otherwise the lowest risk, once probabilities of this position are there
+    m_hintRequested = true;
+    if(m_probabilities && !m_probabilityJob)
+        onProbabilitiesComputed();
+    else if(!m_probabilityJob)
+        requestProbabilities();
+}
+
+void MineFieldItem::setSeed(quint64 seed)
+{
+    m_fixedSeed = seed;
+    m_seedFixed = true;
+    m_boardQueue.clear();
+    if(!m_field.isGenerated())
+        m_seed = seed;
+}
+
+quint64 MineFieldItem::seed() const
+{
+    return m_field.isGenerated() ? m_field.origin().seed : m_seed;
+}
+
+void MineFieldItem::setHint(int idx)
+{
+    clearHint();
+    m_hintCell = idx;
+    m_boardItem->setHint(idx);
+}
+
+void MineFieldItem::clearHint()
+{
+    m_hintRequested = false;
+    m_boardItem->setHint(-1);
+    m_hintCell = -1;
+}
+
+void MineFieldItem::resetSolver()
+{
+    cancelProbabilities();
+    clearHint();
+    // it visits every cell, so it waits for the first use:
+    // starting games one after another stays quick on large fields
+    m_solverOutdated = true;
+}
+
+void MineFieldItem::ensureSolver()
+{
+    if(m_solverOutdated)
+    {
+        m_solver.reset(m_field);
+        m_solverOutdated = false;
     }
-    return resultingList;
 }
 
+void MineFieldItem::requestProbabilities()
+{
+    // results of the previous move are kept on screen until the new ones arrive
+    if(m_probabilityJob)
+        m_probabilityJob->cancelled = true;
+    m_probabilityJob.reset();
+    if(!m_showProbabilities)
+        m_probabilities.reset();
+    if(m_field.isGameOver())
+        m_hintRequested = false;
+    if((!m_showProbabilities && !m_hintRequested) || m_field.isGameOver())
+        return;
 
+    // the solver state is copied here, the game goes on while computing
+    ensureSolver();
+    std::shared_ptr<ProbabilityJob> job = std::make_shared<ProbabilityJob>();
+    job->probabilities.setup(m_solver);
+    m_probabilityJob = job;
+    m_probabilityPool.start(new FunctionTask([this, job]() {
+        // bounded by its step budget: frontiers too large to enumerate are
+        // estimated, so a requested hint is always answered
+        const bool computed = job->probabilities.compute(job->cancelled);
+        QMetaObject::invokeMethod(this, [this, job, computed]() {
+            // superseded by a later move
+            if(job != m_probabilityJob)
+                return;
+            m_probabilityJob.reset();
+            if(computed)
+                m_probabilities = std::shared_ptr<const MineProbability>(job, &job->probabilities);
+            else
+                m_hintRequested = false;
+            onProbabilitiesComputed();
+        }, Qt::QueuedConnection);
+    }));
+}
 
+void MineFieldItem::onProbabilitiesComputed()
+{
+    if(!m_probabilities)
+        return;
+    if(m_showProbabilities)
+        m_probabilityItem->setProbabilities(m_probabilities.get());
+    if(m_hintRequested)
+    {
+        if(m_probabilities->isApproximate())
+            qCDebug(KMINES_LOG) << "hint from estimated probabilities, the frontier is too large to enumerate";
+        setHint(m_probabilities->safestCell([this](int idx) {
+            return m_field.state(idx) == KMinesState::Released;
+        }));
+    }
+}
 
+void MineFieldItem::cancelProbabilities()
+{
+    if(m_probabilityJob)
+        m_probabilityJob->cancelled = true;
+    m_probabilityJob.reset();
+    m_probabilities.reset();
+    m_probabilityItem->setProbabilities(nullptr);
+}
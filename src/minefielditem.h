@@ -8,32 +8,52 @@
 #ifndef MINEFIELDITEM_H
 #define MINEFIELDITEM_H
 
+// own
+#include "boardqueue.h"
+#include "cellatlas.h"
+#include "minefield.h"
+#include "minesolver.h"
 // Qt
-#include <QVector>
 #include <QGraphicsObject>
 #include <QPair>
+#include <QThreadPool>
+#include <QVector>
+// Std
+#include <memory>
 
 class KGameRenderer;
-class CellItem;
-class BorderItem;
+class BoardItem;
+class MineProbability;
+class ProbabilityItem;
 
 typedef QPair<int,int> FieldPos;
 
 /**
  * Graphics item that represents MineField.
- * It is composed of many (or little) of CellItems.
- * This class is responsible of generation game field
- * with given properties (num rows, num cols, num mines) and
- * handling resizes
+ * Cells are painted by a single BoardItem.
+ * This class is a view and controller of the MineField model:
+ * it translates mouse events into game moves, keeps the board
+ * in sync with the model and handles resizes
  */
 class MineFieldItem : public QGraphicsObject
 {
     Q_OBJECT
 public:
+    /**
+     * Move played by playMoves()
+     */
+    struct Move
+    {
+        enum Type : quint8 { Reveal, ToggleFlag, Chord };
+        Type type;
+        int idx;
+    };
+
     /**
      * Constructor.
      */
     explicit MineFieldItem(KGameRenderer* renderer);
+    ~MineFieldItem() override;
     /**
      * Initializes game field: creates items, places them on positions,
      * (re)sets some variables
@@ -41,8 +61,9 @@ public:
      * @param numRows number of rows
      * @param numCols number of columns
      * @param numMines number of mines
+     * @param noGuess whether the field must be solvable without guessing
      */
-    void initField( int numRows, int numCols, int numMines );
+    void initField( int numRows, int numCols, int numMines, bool noGuess = false );
     /**
      * Resets mines to the initial state.
      */
@@ -51,6 +72,10 @@ public:
      * Resizes this graphics item so it fits in given rect
      */
     void resizeToFitInRect(const QRectF& rect);
+    /**
+     * @return cell size resizeToFitInRect(rect) would choose
+     */
+    int cellSizeFor(const QRectF& rect) const;
     /**
      * Reimplemented from QGraphicsItem
      */
@@ -67,16 +92,69 @@ public:
      * @return num mines in field
      */
     int minesCount() const;
+    /**
+     * @return the game model, changed only by this item
+     */
+    const MineField& field() const;
+    /**
+     * Plays moves in order as if the player made them, until the game is over.
+     * They are shown as a single move, on the cell of the last one.
+     * Moves out of the field are skipped, nothing is played while paused
+     *
+     * @return number of moves played
+     */
+    int playMoves(const QVector<Move>& moves);
+    /**
+     * Shows or hides mine probabilities of unrevealed cells.
+     * They are computed in background after every move
+     */
+    void setShowProbabilities(bool show);
+    /**
+     * @return probability that cell at (row,col) holds a mine
+     * or -1 if it is not computed yet
+     */
+    double mineProbability(int row, int col) const;
+    /**
+     * Highlights a cell which is certainly safe, or the least
+     * likely to hold a mine if there is none
+     */
+    void showHint();
+    /**
+     * Generates this and the following fields from seed instead of a random
+     * one, from the next field not generated yet on. The same seed and first
+     * click give the same field, so games can be reproduced or shared
+     */
+    void setSeed(quint64 seed);
+    /**
+     * @return seed the current field is generated from, once generated.
+     * Prepared fields of no guess levels may have been generated for
+     * another first click and mirrored, see MineField::origin()
+     */
+    quint64 seed() const;
 
     /**
      * Minimal number of free positions on a field
      */
-    static const int MINIMAL_FREE = 10;
+    static const int MINIMAL_FREE = MineField::MINIMAL_FREE;
+    /**
+     * Fields with more cells keep MIN_LARGE_FIELD_CELL_SIZE
+     * and are scrolled when they don't fit at this size
+     */
+    static const int LARGE_FIELD_CELLS = 50*50;
+    static const int MIN_LARGE_FIELD_CELL_SIZE = 16;
 
 Q_SIGNALS:
     void flaggedMinesCountChanged(int);
     void firstClickDone();
     void gameOver(bool won);
+    /**
+     * Emitted after a move with the cells it changed. May contain duplicates
+     */
+    void cellsChanged(const std::vector<int>& cells);
+    /**
+     * Emitted when all cells are released again, for a new game or a reset
+     */
+    void fieldReset();
 private:
     // reimplemented
     void mousePressEvent( QGraphicsSceneMouseEvent * ) override;
@@ -86,118 +164,126 @@ private:
     void mouseMoveEvent( QGraphicsSceneMouseEvent * ) override;
 
     /**
-     * Returns cell item at (row,col).
-     * Always use this function instead hand-computing index in m_cells
+     * Places mines on the first reveal, on cell at idx
      */
-    inline CellItem* itemAt(int row, int col) { return m_cells.at( row*m_numCols + col ); }
+    void ensureGenerated(int idx);
     /**
-     * Overloaded one, which takes QPair
+     * Shows all cells around (row,col) as pressed
      */
-    inline CellItem* itemAt( FieldPos pos ) { return itemAt(pos.first,pos.second); }
+    void pressNeighbours(int row, int col);
     /**
-     * Calculates (row,col) from given index in m_cells and returns them in QPair
+     * Shows all cells around (row,col) as released
      */
-    inline FieldPos rowColFromIndex(int idx)
-        {
-            int row = idx/m_numCols;
-            return qMakePair(row, idx - row*m_numCols);
-        }
+    void undoPressNeighbours(int row, int col);
     /**
-     * Generates game field ensuring that cell at clickedIdx
-     * will be empty to allow the player quickly jump into the game.
-     *
-     * @param clickedIdx specifies index which should NOT have mine and be empty
+     * Updates cells changed in the model by the last move made
+     * on cell at idx and emits signals about the move outcome
      */
-    void generateField(int clickedIdx);
+    void finishMove(MineField::GameResult result, int idx);
     /**
-     * Returns all adjacent items for item at row, col
+     * Restarts the solver, for a new game or after a reset
      */
-    QList<CellItem*> adjacentItemsFor(int row, int col);
+    void resetSolver();
     /**
-     * Returns all valid adjacent row,col pairs for row, col
+     * Brings the solver to the start of the game if it was reset since
      */
-    QList<FieldPos> adjacentRowColsFor(int row, int col);
+    void ensureSolver();
     /**
-     * Checks if player lost the game. Return `true` if lost.
-     * A `true` return value and a `false` `m_gameOver` indicates that the game is restarted.
+     * Starts computing probabilities of the current position,
+     * cancelling the computation started by the previous move
      */
-    bool checkLost();
+    void requestProbabilities();
     /**
-     * Checks if player won the game. Return `true` if won.
+     * Cancels the running computation and hides probabilities
      */
-    bool checkWon();
+    void cancelProbabilities();
     /**
-     * Reveals all unmarked items containing mines
+     * Shows new probabilities and answers a pending hint request
      */
-    void revealAllMines();
+    void onProbabilitiesComputed();
     /**
-     * Reimplemented from QGraphicsItem
-     */
-    void paint( QPainter * painter, const QStyleOptionGraphicsItem*, QWidget * widget = nullptr ) override;
-    /**
-     * Repositions all child cell items upon resizes
+     * Highlights cell at idx, removing the previous highlight
      */
-    void adjustItemPositions();
+    void setHint(int idx);
     /**
-     * Reveals all empty cells around cell at (row,col),
-     * until it found cells with digits (which are also revealed)
+     * Removes the highlight and forgets any pending hint request
      */
-    void revealEmptySpace(int row, int col);
+    void clearHint();
     /**
-     * Sets up border items (positions and properties)
+     * Reimplemented from QGraphicsItem
      */
-    void setupBorderItems();
+    void paint( QPainter * painter, const QStyleOptionGraphicsItem*, QWidget * widget = nullptr ) override;
 
     /**
-     * Return `true` if the game is finished (and possibly restarted) after the call.
+     * The game model
      */
-    bool onItemRevealed(int row, int col);
-    // overload
-    bool onItemRevealed(CellItem* item);
+    MineField m_field;
 
-    // note: in member functions use itemAt (see above )
-    // instead of hand-computing index from row & col!
-    // => not depend on how m_cells is represented
     /**
-     * Array which holds all child cell items
+     * Looks of cells rendered at m_cellSize
      */
-    QVector<CellItem*> m_cells;
+    CellAtlas m_atlas;
     /**
-     * Array which holds border items
+     * Item painting the whole field
      */
-    QVector<BorderItem*> m_borders;
+    BoardItem* m_boardItem;
     /**
      * The width and height of minefield cells in scene coordinates
      */
     int m_cellSize;
     /**
-     * Number of field rows
+     * row and column where mouse was pressed.
+     * (-1,-1) if it is already released
      */
-    int m_numRows;
+    FieldPos m_leftButtonPos;
+    FieldPos m_midButtonPos;
+    bool m_emulatingMidButton;
     /**
-     * Number of field columns
+     * Whether the field is generated by NoGuessGenerator
      */
-    int m_numCols;
+    bool m_noGuess = false;
     /**
-     * Number of mines in field
+     * Seed of the current field, chosen by initField()
      */
-    int m_minesCount;
+    quint64 m_seed = 0;
     /**
-     * Number of flagged mines
+     * Seed given to setSeed(), if any
      */
-    int m_flaggedMinesCount;
+    quint64 m_fixedSeed = 0;
+    bool m_seedFixed = false;
     /**
-     * row and column where mouse was pressed.
-     * (-1,-1) if it is already released
+     * Fields solvable without guessing, prepared during the game
      */
-    FieldPos m_leftButtonPos;
-    FieldPos m_midButtonPos;
-    bool m_firstClick;
-    bool m_gameOver;
-    bool m_emulatingMidButton;
-    int m_numUnrevealed;
+    BoardQueue m_boardQueue;
+    /**
+     * Adviser following what the player knows
+     */
+    MineSolver m_solver;
+    bool m_solverOutdated = true;
 
-    KGameRenderer* m_renderer;
+    struct ProbabilityJob;
+    /**
+     * Probabilities of the position after the last move, being computed
+     */
+    std::shared_ptr<ProbabilityJob> m_probabilityJob;
+    /**
+     * Last computed probabilities, shown by m_probabilityItem
+     */
+    std::shared_ptr<const MineProbability> m_probabilities;
+    ProbabilityItem* m_probabilityItem;
+    /**
+     * Single thread pool running probability computations
+     */
+    QThreadPool m_probabilityPool;
+    bool m_showProbabilities = false;
+    /**
+     * Cell highlighted by the last hint, -1 if none
+     */
+    int m_hintCell = -1;
+    /**
+     * Whether a hint waits for probabilities being computed
+     */
+    bool m_hintRequested = false;
 };
 
 #endif
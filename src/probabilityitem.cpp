@@ -0,0 +1,73 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "probabilityitem.h"
+
+// own
+#include "minefield.h"
+#include "mineprobability.h"
+// Qt
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+ProbabilityItem::ProbabilityItem(const MineField* field, QGraphicsItem* parent)
+    : QGraphicsItem(parent), m_field(field)
+{
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+    setAcceptedMouseButtons(Qt::NoButton);
+    // above the board
+    setZValue(1);
+}
+
+void ProbabilityItem::setProbabilities(const MineProbability* probabilities)
+{
+    m_probabilities = probabilities;
+    update();
+}
+
+void ProbabilityItem::setCellSize(int cellSize)
+{
+    prepareGeometryChange();
+    m_cellSize = cellSize;
+}
+
+QRectF ProbabilityItem::boundingRect() const
+{
+    // +2 - because of border on each side
+    return QRectF(0, 0, m_cellSize*(m_field->columnCount()+2), m_cellSize*(m_field->rowCount()+2));
+}
+
+void ProbabilityItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(widget);
+    if(!m_probabilities || m_cellSize <= 0)
+        return;
+
+    // only cells intersecting the exposed rect
+    const QRectF exposed = option->exposedRect;
+    const int firstRow = qMax(0, static_cast<int>(exposed.top()/m_cellSize) - 1);
+    const int lastRow = qMin(m_field->rowCount() - 1, static_cast<int>(exposed.bottom()/m_cellSize));
+    const int firstCol = qMax(0, static_cast<int>(exposed.left()/m_cellSize) - 1);
+    const int lastCol = qMin(m_field->columnCount() - 1, static_cast<int>(exposed.right()/m_cellSize));
+
+    const bool showText = m_cellSize >= 20;
+    QFont font = painter->font();
+    font.setPixelSize(m_cellSize/3);
+    painter->setFont(font);
+    painter->setPen(Qt::black);
+    for(int row = firstRow; row <= lastRow; ++row)
+        for(int col = firstCol; col <= lastCol; ++col)
+        {
+            const int idx = m_field->index(row, col);
+            if(m_field->state(idx) != KMinesState::Released)
+                continue;
+            const double probability = m_probabilities->probability(idx);
+            const QRectF rect((col+1)*m_cellSize, (row+1)*m_cellSize, m_cellSize, m_cellSize);
+            painter->fillRect(rect, QColor::fromHsvF((1 - probability)/3, 1, 1, 0.35));
+            if(showText)
+                painter->drawText(rect, Qt::AlignCenter, QString::number(qRound(probability*100)));
+        }
+}
@@ -0,0 +1,44 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef PROBABILITYITEM_H
+#define PROBABILITYITEM_H
+
+// Qt
+#include <QGraphicsItem>
+
+class MineField;
+class MineProbability;
+
+/**
+ * Graphics item showing the mine probability of every unrevealed
+ * cell above the board: cells are tinted from green (safe) to red
+ * (mined), with the percentage written when cells are big enough.
+ * It covers the whole field of its MineFieldItem parent and paints
+ * only the exposed cells.
+ */
+class ProbabilityItem : public QGraphicsItem
+{
+public:
+    ProbabilityItem(const MineField* field, QGraphicsItem* parent);
+    /**
+     * Sets probabilities to show, or nullptr to show nothing.
+     * They are not owned and must stay valid until the next call
+     */
+    void setProbabilities(const MineProbability* probabilities);
+    void setCellSize(int cellSize);
+    /**
+     * Reimplemented from QGraphicsItem
+     */
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
+private:
+    const MineField* m_field;
+    const MineProbability* m_probabilities = nullptr;
+    int m_cellSize = 0;
+};
+
+#endif
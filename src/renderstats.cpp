@@ -0,0 +1,9 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "renderstats.h"
+
+int RenderStats::s_spriteRequests = 0;
@@ -0,0 +1,28 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef RENDERSTATS_H
+#define RENDERSTATS_H
+
+/**
+ * Counts pixmaps the game requests from KGameRenderer, so benchmarks
+ * can tell how many sprites an action renders or looks up in its cache.
+ * Only used in the GUI thread
+ */
+class RenderStats
+{
+public:
+    /**
+     * @return number of sprites requested so far, with
+     * KGameRenderer::spritePixmap() or rendered in background
+     */
+    static int spriteRequests() { return s_spriteRequests; }
+    static void countSpriteRequest() { ++s_spriteRequests; }
+private:
+    static int s_spriteRequests;
+};
+
+#endif
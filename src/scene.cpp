@@ -8,8 +8,10 @@
 #include "scene.h"
 
 // own
+#include "cellatlas.h"
 #include "settings.h"
 #include "minefielditem.h"
+#include "renderstats.h"
 // KDEGames
 #include <KGamePopupItem>
 #include <KgThemeProvider>
@@ -23,11 +25,34 @@
 KMinesView::KMinesView( KMinesScene* scene, QWidget *parent )
     : QGraphicsView(scene, parent), m_scene(scene)
 {
+    m_resizeTimer.setSingleShot(true);
+    m_resizeTimer.setInterval(100);
+    connect(&m_resizeTimer, &QTimer::timeout, this, &KMinesView::onResizeSettled);
+    // the scene now matches the view size, drop the temporary scaling
+    connect(m_scene, &KMinesScene::resized, this, &KMinesView::resetTransform);
 }
 
 void KMinesView::resizeEvent( QResizeEvent *ev )
 {
-    m_scene->resizeScene( ev->size().width(), ev->size().height() );
+    QGraphicsView::resizeEvent(ev);
+    const QSize oldSize = m_scene->viewSize();
+    if(oldSize.isEmpty())
+    {
+        m_scene->resizeScene( ev->size().width(), ev->size().height() );
+        return;
+    }
+
+    // rendering sprites at every step of a window resize is slow on big
+    // fields: show the current ones scaled until resizing settles
+    const qreal scale = qMin(qreal(ev->size().width()) / oldSize.width(),
+                             qreal(ev->size().height()) / oldSize.height());
+    setTransform(QTransform::fromScale(scale, scale));
+    m_resizeTimer.start();
+}
+
+void KMinesView::onResizeSettled()
+{
+    m_scene->resizeSceneLater( viewport()->width(), viewport()->height() );
 }
 
 // -------------- KMinesScene --------------------
@@ -41,7 +66,7 @@ static KgThemeProvider* provider()
 }
 
 KMinesScene::KMinesScene( QObject* parent )
-    : QGraphicsScene(parent), m_renderer(provider())
+    : QGraphicsScene(parent), m_renderer(provider()), m_prefetcher(&m_renderer)
 {
     setItemIndexMethod( NoIndex );
     m_fieldItem = new MineFieldItem(&m_renderer);
@@ -63,6 +88,7 @@ KMinesScene::KMinesScene( QObject* parent )
     m_gamePausedMessageItem->setHideOnMouseClick(false);
     addItem(m_gamePausedMessageItem);
     
+    RenderStats::countSpriteRequest();
     setBackgroundBrush(m_renderer.spritePixmap(QStringLiteral( "mainWidget" ), sceneRect().size().toSize()));
 }
 
@@ -72,6 +98,21 @@ void KMinesScene::reset()
     m_messageItem->forceHide();
 }
 
+void KMinesScene::setShowProbabilities(bool show)
+{
+    m_fieldItem->setShowProbabilities(show);
+}
+
+void KMinesScene::showHint()
+{
+    m_fieldItem->showHint();
+}
+
+void KMinesScene::setSeed(quint64 seed)
+{
+    m_fieldItem->setSeed(seed);
+}
+
 bool KMinesScene::canScore() const
 {
     return m_canScore;
@@ -84,25 +125,52 @@ void KMinesScene::setCanScore(bool value)
 
 void KMinesScene::resizeScene(int width, int height)
 {
-    setSceneRect(0, 0, width, height);
-    setBackgroundBrush(m_renderer.spritePixmap(QStringLiteral( "mainWidget" ), sceneRect().size().toSize()));
-    m_fieldItem->resizeToFitInRect( sceneRect() );
+    m_viewSize = QSize(width, height);
+    m_fieldItem->resizeToFitInRect( QRectF(0, 0, width, height) );
+    const QSizeF fieldSize = m_fieldItem->boundingRect().size();
+    setSceneRect(0, 0, qMax<qreal>(width, fieldSize.width()), qMax<qreal>(height, fieldSize.height()));
+    // the brush is tiled over larger scenes
+    RenderStats::countSpriteRequest();
+    setBackgroundBrush(m_renderer.spritePixmap(QStringLiteral( "mainWidget" ), m_viewSize));
     m_fieldItem->setPos( sceneRect().width()/2 - m_fieldItem->boundingRect().width()/2,
                          sceneRect().height()/2 - m_fieldItem->boundingRect().height()/2 );
     m_gamePausedMessageItem->setPos( sceneRect().width()/2 - m_gamePausedMessageItem->boundingRect().width()/2,
                           sceneRect().height()/2 - m_gamePausedMessageItem->boundingRect().height()/2 );
     m_messageItem->setPos( sceneRect().width()/2 - m_messageItem->boundingRect().width()/2,
                           sceneRect().height()/2 - m_messageItem->boundingRect().height()/2 );
+    Q_EMIT resized();
+}
+
+void KMinesScene::resizeSceneLater(int width, int height)
+{
+    const int cellSize = m_fieldItem->cellSizeFor( QRectF(0, 0, width, height) );
+    const QSize cellSize2D(cellSize, cellSize);
+    QVector<QPair<QString, QSize> > sprites;
+    const QStringList keys = CellAtlas::spriteKeys();
+    for (const QString& key : keys) {
+        sprites.append(qMakePair(key, cellSize2D));
+    }
+    sprites.append(qMakePair(QStringLiteral( "mainWidget" ), QSize(width, height)));
+
+    // everything is swapped at once when all sprites are there
+    m_prefetcher.prefetch(sprites, [this, width, height]() {
+        resizeScene(width, height);
+    });
+}
+
+QSize KMinesScene::viewSize() const
+{
+    return m_viewSize;
 }
 
-void KMinesScene::startNewGame(int rows, int cols, int numMines)
+void KMinesScene::startNewGame(int rows, int cols, int numMines, bool noGuess)
 {
     // hide message if any
     m_messageItem->forceHide();
 
-    m_fieldItem->initField(rows, cols, numMines);
+    m_fieldItem->initField(rows, cols, numMines, noGuess);
     // reposition items
-    resizeScene((int)sceneRect().width(), (int)sceneRect().height());
+    resizeScene(m_viewSize.width(), m_viewSize.height());
 }
 
 int KMinesScene::totalMines() const
@@ -8,11 +8,14 @@
 #ifndef SCENE_H
 #define SCENE_H
 
+// own
+#include "spriteprefetcher.h"
 // KDEGames
 #include <KGameRenderer>
 // Qt
 #include <QGraphicsView>
 #include <QGraphicsScene>
+#include <QTimer>
 
 class MineFieldItem;
 class KGamePopupItem;
@@ -29,17 +32,30 @@ public:
      */
     explicit KMinesScene( QObject* parent );
     /**
-     * Resizes scene to given dimensions
+     * Resizes scene to fit a view of given dimensions.
+     * Fields not fitting in it at their minimal cell size
+     * make the scene larger, so the view scrolls
      */
     void resizeScene(int width, int height);
+    /**
+     * Like resizeScene(), once sprites of the new size are rendered
+     * in background. Meanwhile the scene keeps its current size
+     */
+    void resizeSceneLater(int width, int height);
+    /**
+     * @return view size given to the last resizeScene() call
+     */
+    QSize viewSize() const;
     /**
      * @return total number of mines in field
      */
     int totalMines() const;
     /**
      * Starts new game
+     *
+     * @param noGuess whether the field must be solvable without guessing
      */
-    void startNewGame(int rows, int cols, int numMines);
+    void startNewGame(int rows, int cols, int numMines, bool noGuess = false);
     /**
      * Toggles paused state for all cells in the field item
      */
@@ -48,8 +64,24 @@ public:
      * Resets the scene
      */
     void reset();
+    /**
+     * Shows or hides mine probabilities over the field
+     */
+    void setShowProbabilities(bool show);
+    /**
+     * Highlights a safe (or the safest) cell of the field
+     */
+    void showHint();
+    /**
+     * Generates fields from seed, see MineFieldItem::setSeed()
+     */
+    void setSeed(quint64 seed);
 
     KGameRenderer& renderer() {return m_renderer;}
+    /**
+     * @return the field item, for players other than the mouse
+     */
+    MineFieldItem* fieldItem() const {return m_fieldItem;}
     /**
      * Represents if the scores should be considered for the highscores
      */
@@ -60,11 +92,23 @@ Q_SIGNALS:
     void minesCountChanged(int);
     void gameOver(bool);
     void firstClickDone();
+    /**
+     * Emitted when the scene is laid out for a new view size
+     */
+    void resized();
 private Q_SLOTS:
     void onGameOver(bool);
 private:
     bool m_canScore;
+    /**
+     * Size of the view, given to the last resizeScene() call
+     */
+    QSize m_viewSize;
     KGameRenderer m_renderer;
+    /**
+     * Renders sprites of the next size for resizeSceneLater()
+     */
+    SpritePrefetcher m_prefetcher;
     /**
      * Game field graphics item
      */
@@ -82,7 +126,16 @@ public:
     KMinesView( KMinesScene* scene, QWidget *parent );
 private:
     void resizeEvent( QResizeEvent *ev ) override;
+    /**
+     * Lays out the scene for the final view size
+     */
+    void onResizeSettled();
 
     KMinesScene* m_scene = nullptr;
+    /**
+     * Restarted by each resize, so the scene is rendered
+     * again only once resizing settles
+     */
+    QTimer m_resizeTimer;
 };
 #endif
@@ -0,0 +1,167 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// own
+#include "minefield.h"
+#include "simulator.h"
+#include "workstealingpool.h"
+// Qt
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+// Std
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+/**
+ * @return the smallest value of histogram (games by value) reached by
+ * a fraction of the games
+ */
+int quantile(const std::vector<int>& histogram, int games, double fraction)
+{
+    const double needed = fraction * games;
+    long long seen = 0;
+    for (int value = 0; value < static_cast<int>(histogram.size()); ++value) {
+        seen += histogram[value];
+        if (seen > 0 && seen >= needed)
+            return value;
+    }
+    return static_cast<int>(histogram.size()) - 1;
+}
+
+double mean(const std::vector<int>& histogram, int games)
+{
+    double sum = 0;
+    for (int value = 0; value < static_cast<int>(histogram.size()); ++value)
+        sum += double(value) * histogram[value];
+    return games > 0 ? sum / games : 0;
+}
+
+void printSummary(QTextStream& out, const char* name, const std::vector<int>& histogram, int games)
+{
+    out << name << ": mean " << QString::number(mean(histogram, games), 'f', 2)
+        << ", min " << quantile(histogram, games, 0)
+        << ", p10 " << quantile(histogram, games, 0.1)
+        << ", median " << quantile(histogram, games, 0.5)
+        << ", p90 " << quantile(histogram, games, 0.9)
+        << ", max " << quantile(histogram, games, 1) << '\n';
+}
+
+/**
+ * @return value of option as a positive number, or 0 if it isn't one
+ */
+int positiveValue(const QCommandLineParser& parser, const QCommandLineOption& option)
+{
+    bool ok = false;
+    const int value = parser.value(option).toInt(&ok);
+    return ok && value > 0 ? value : 0;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("kmines-sim"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+        "Plays KMines games with a solver strategy: safe cells first, "
+        "otherwise the cell least likely to hold a mine."));
+    parser.addHelpOption();
+    const QCommandLineOption rowsOption(QStringLiteral("rows"), QStringLiteral("Number of rows."),
+                                        QStringLiteral("rows"), QStringLiteral("16"));
+    const QCommandLineOption colsOption(QStringLiteral("cols"), QStringLiteral("Number of columns."),
+                                        QStringLiteral("cols"), QStringLiteral("30"));
+    const QCommandLineOption minesOption(QStringLiteral("mines"), QStringLiteral("Number of mines."),
+                                         QStringLiteral("mines"), QStringLiteral("99"));
+    const QCommandLineOption gamesOption(QStringLiteral("games"), QStringLiteral("Number of games played."),
+                                         QStringLiteral("games"), QStringLiteral("10000"));
+    const QCommandLineOption generatorOption(QStringLiteral("generator"),
+                                             QStringLiteral("How fields are generated: random or noguess."),
+                                             QStringLiteral("generator"), QStringLiteral("random"));
+    const QCommandLineOption seedOption(QStringLiteral("seed"),
+                                        QStringLiteral("Seed of the games, the same seed plays the same games."),
+                                        QStringLiteral("seed"), QStringLiteral("1"));
+    const QCommandLineOption threadsOption(QStringLiteral("threads"),
+                                           QStringLiteral("Number of threads, all cores by default."),
+                                           QStringLiteral("threads"), QStringLiteral("0"));
+    parser.addOption(rowsOption);
+    parser.addOption(colsOption);
+    parser.addOption(minesOption);
+    parser.addOption(gamesOption);
+    parser.addOption(generatorOption);
+    parser.addOption(seedOption);
+    parser.addOption(threadsOption);
+    parser.process(app);
+
+    const int rows = positiveValue(parser, rowsOption);
+    const int cols = positiveValue(parser, colsOption);
+    const int mines = positiveValue(parser, minesOption);
+    const int games = positiveValue(parser, gamesOption);
+    if (rows == 0 || cols == 0 || mines == 0 || games == 0)
+    {
+        qCritical("Rows, columns, mines and games must be positive numbers");
+        return 1;
+    }
+    if (rows*cols - mines < MineField::MINIMAL_FREE)
+    {
+        qCritical("At least %d cells must be free of mines", MineField::MINIMAL_FREE);
+        return 1;
+    }
+    Simulator::Generator generator;
+    if (parser.value(generatorOption) == QLatin1String("random"))
+        generator = Simulator::RandomFields;
+    else if (parser.value(generatorOption) == QLatin1String("noguess"))
+        generator = Simulator::NoGuessFields;
+    else
+    {
+        qCritical("Invalid generator: %s", qPrintable(parser.value(generatorOption)));
+        return 1;
+    }
+    bool seedOk = false;
+    const quint64 seed = parser.value(seedOption).toULongLong(&seedOk);
+    if (!seedOk)
+    {
+        qCritical("Invalid seed: %s", qPrintable(parser.value(seedOption)));
+        return 1;
+    }
+
+    WorkStealingPool pool(parser.value(threadsOption).toInt());
+    const Simulator simulator(rows, cols, mines, generator, seed);
+    QElapsedTimer timer;
+    timer.start();
+    const Simulator::Statistics statistics = simulator.run(games, pool);
+    const double seconds = timer.nsecsElapsed() / 1e9;
+
+    QTextStream out(stdout);
+    const double winRate = double(statistics.won) / statistics.games;
+    // normal approximation of the 95% confidence interval
+    const double margin = 1.96 * std::sqrt(winRate * (1 - winRate) / statistics.games);
+    out << "Field: " << rows << 'x' << cols << ", " << mines << " mines, "
+        << parser.value(generatorOption) << " fields, seed " << seed << '\n';
+    out << "Games: " << statistics.games << " in " << QString::number(seconds, 'f', 2) << " s, "
+        << QString::number(statistics.games / seconds, 'f', 0) << " games/s on "
+        << pool.threadCount() << " threads\n";
+    out << "Won: " << statistics.won << " (" << QString::number(100 * winRate, 'f', 2)
+        << "% +- " << QString::number(100 * margin, 'f', 2) << "%)\n";
+    if (generator == Simulator::NoGuessFields)
+        out << "No-guess searches failed: " << statistics.noGuessFailures << '\n';
+    printSummary(out, "Guesses", statistics.guesses, statistics.games);
+    for (int guesses = 0; guesses < static_cast<int>(statistics.guesses.size()); ++guesses) {
+        if (statistics.guesses[guesses] > 0)
+            out << "  " << guesses << ": " << statistics.guesses[guesses] << " ("
+                << QString::number(100.0 * statistics.guesses[guesses] / statistics.games, 'f', 2) << "%)\n";
+    }
+    out << "Guesses from estimated probabilities: " << statistics.approximateGuesses << '\n';
+    printSummary(out, "3BV", statistics.bbbv, statistics.games);
+    return 0;
+}
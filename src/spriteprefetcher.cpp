@@ -0,0 +1,150 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "spriteprefetcher.h"
+
+// own
+#include "renderstats.h"
+// KDEGames
+#include <KGameRenderer>
+#include <KGameRendererClient>
+
+class SpritePrefetcher::Client : public KGameRendererClient
+{
+public:
+    Client(SpritePrefetcher* prefetcher, const QString& spriteKey)
+        : KGameRendererClient(prefetcher->m_renderer, spriteKey), m_prefetcher(prefetcher)
+    {
+    }
+    /**
+     * Whether the running request waits for this sprite
+     */
+    bool m_waiting = false;
+    /**
+     * Whether the sprite is rendered with the current key and size
+     */
+    bool m_rendered = false;
+protected:
+    void receivePixmap(const QPixmap& pixmap) override
+    {
+        Q_UNUSED(pixmap);
+        // results for a previous key or size may still arrive
+        if(m_rendered || renderSize() != m_requestedSize || spriteKey() != m_requestedKey)
+            return;
+        m_rendered = true;
+        if(m_waiting)
+        {
+            m_waiting = false;
+            m_prefetcher->received();
+        }
+    }
+private:
+    friend class SpritePrefetcher;
+    SpritePrefetcher* m_prefetcher;
+    QString m_requestedKey;
+    QSize m_requestedSize;
+};
+
+SpritePrefetcher::SpritePrefetcher(KGameRenderer* renderer)
+    : m_renderer(renderer)
+{
+    m_themeChanged = QObject::connect(renderer, &KGameRenderer::themeChanged, [this]() { onThemeChanged(); });
+}
+
+SpritePrefetcher::~SpritePrefetcher()
+{
+    QObject::disconnect(m_themeChanged);
+}
+
+void SpritePrefetcher::prefetch(const QVector<QPair<QString, QSize> >& sprites, const std::function<void()>& done)
+{
+    cancel();
+    while(m_clients.size() < static_cast<size_t>(sprites.size()))
+        m_clients.emplace_back(new Client(this, sprites.at(m_clients.size()).first));
+
+    m_done = done;
+    m_requestSize = sprites.size();
+    // one more, so done is not called before all sprites are requested
+    m_missing = sprites.size() + 1;
+    for(int i = 0; i < sprites.size(); ++i)
+    {
+        Client* client = m_clients[i].get();
+        const QString& key = sprites.at(i).first;
+        const QSize& size = sprites.at(i).second;
+        if(client->m_requestedKey != key || client->m_requestedSize != size)
+        {
+            client->m_requestedKey = key;
+            client->m_requestedSize = size;
+            client->m_rendered = false;
+        }
+        // themes may lack some sprites, they are never received
+        if(client->m_rendered || !m_renderer->spriteExists(key))
+        {
+            received();
+            continue;
+        }
+        client->m_waiting = true;
+        RenderStats::countSpriteRequest();
+        // cached sprites are received right here
+        client->setSpriteKey(key);
+        client->setRenderSize(size);
+    }
+    received();
+}
+
+void SpritePrefetcher::cancel()
+{
+    m_done = nullptr;
+    m_requestSize = 0;
+    m_missing = 0;
+    for (const std::unique_ptr<Client>& client : m_clients) {
+        client->m_waiting = false;
+    }
+}
+
+void SpritePrefetcher::received()
+{
+    if(--m_missing > 0 || !m_done)
+        return;
+    const std::function<void()> done = m_done;
+    m_done = nullptr;
+    done();
+}
+
+void SpritePrefetcher::onThemeChanged()
+{
+    for (const std::unique_ptr<Client>& client : m_clients) {
+        client->m_rendered = false;
+    }
+    if(!m_done)
+        return;
+
+    // one more, so done is not called before all sprites are requested again
+    ++m_missing;
+    for(int i = 0; i < m_requestSize; ++i)
+    {
+        Client* client = m_clients[i].get();
+        if(!m_renderer->spriteExists(client->m_requestedKey))
+        {
+            if(client->m_waiting)
+            {
+                client->m_waiting = false;
+                received();
+            }
+            continue;
+        }
+        if(!client->m_waiting)
+        {
+            client->m_waiting = true;
+            ++m_missing;
+        }
+        RenderStats::countSpriteRequest();
+        // the renderer only fetches again for a new size
+        client->setRenderSize(QSize());
+        client->setRenderSize(client->m_requestedSize);
+    }
+    received();
+}
@@ -0,0 +1,74 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SPRITEPREFETCHER_H
+#define SPRITEPREFETCHER_H
+
+// Qt
+#include <QMetaObject>
+#include <QPair>
+#include <QSize>
+#include <QString>
+#include <QVector>
+// Std
+#include <functional>
+#include <memory>
+#include <vector>
+
+class KGameRenderer;
+
+/**
+ * Renders sprites ahead of time in the worker threads of a KGameRenderer.
+ *
+ * Once they are done they sit in the renderer cache, so asking
+ * KGameRenderer::spritePixmap() for them is quick.
+ */
+class SpritePrefetcher
+{
+public:
+    explicit SpritePrefetcher(KGameRenderer* renderer);
+    ~SpritePrefetcher();
+    /**
+     * Starts rendering (key, size) sprites, cancelling the previous request.
+     * done is called in the GUI thread once all of them are rendered,
+     * right away if they already are
+     */
+    void prefetch(const QVector<QPair<QString, QSize> >& sprites, const std::function<void()>& done);
+    /**
+     * Forgets the running request, its done function won't be called
+     */
+    void cancel();
+private:
+    class Client;
+    friend class Client;
+    /**
+     * Called when a sprite of the running request is rendered
+     */
+    void received();
+    /**
+     * Sprites rendered for the previous theme don't count any more,
+     * those of the running request are rendered again
+     */
+    void onThemeChanged();
+
+    KGameRenderer* m_renderer;
+    /**
+     * One renderer client per sprite, reused by later requests
+     */
+    std::vector<std::unique_ptr<Client> > m_clients;
+    /**
+     * Number of sprites of the running request, they use the first clients
+     */
+    int m_requestSize = 0;
+    /**
+     * Number of sprites of the running request still being rendered
+     */
+    int m_missing = 0;
+    std::function<void()> m_done;
+    QMetaObject::Connection m_themeChanged;
+};
+
+#endif